@@ -18,6 +18,7 @@
 
 #include <grpc++/grpc++.h>
 
+#include "flatbuffers/grpc.h"
 #include "monster_test_generated.h"
 #include "monster_test.grpc.fb.h"
 
@@ -26,6 +27,10 @@ using namespace MyGame::Example;
 // The callback implementation of our server, that derives from the generated
 // code. It implements all rpcs specified in the FlatBuffers schema.
 class ServiceImpl final : public MyGame::Example::MonsterStorage::Service {
+ public:
+  ServiceImpl() : allocator_(pool_), fbb_(1024, &allocator_) {}
+
+ private:
   virtual ::grpc::Status Store(::grpc::ServerContext* context,
                                const flatbuffers::BufferRef<Monster> *request,
                                flatbuffers::BufferRef<Stat> *response)
@@ -35,11 +40,10 @@ class ServiceImpl final : public MyGame::Example::MonsterStorage::Service {
     auto stat_offset = CreateStat(fbb_, fbb_.CreateString("Hello, " +
                                         request->GetRoot()->name()->str()));
     fbb_.Finish(stat_offset);
-    // Since we keep reusing the same FlatBufferBuilder, the memory it owns
-    // remains valid until the next call (this BufferRef doesn't own the
-    // memory it points to).
-    *response = flatbuffers::BufferRef<Stat>(fbb_.GetBufferPointer(),
-                                             fbb_.GetSize());
+    // Hand the finished buffer to GRPC without copying it. Once it has been
+    // sent, its memory goes back to pool_, where the next call to Clear()
+    // above picks it up again.
+    *response = flatbuffers::ReleaseBufferRef<Stat>(fbb_);
     return grpc::Status::OK;
   }
   virtual ::grpc::Status Retrieve(::grpc::ServerContext *context,
@@ -50,7 +54,10 @@ class ServiceImpl final : public MyGame::Example::MonsterStorage::Service {
     return grpc::Status::CANCELLED;
   }
 
- private:
+  // Members are destroyed in reverse order: the builder has to go before its
+  // allocator, which has to go before the pool.
+  flatbuffers::SlicePool pool_;
+  flatbuffers::SliceAllocator allocator_;
   flatbuffers::FlatBufferBuilder fbb_;
 };
 
@@ -99,8 +106,11 @@ int main(int /*argc*/, const char * /*argv*/[]) {
   flatbuffers::FlatBufferBuilder fbb;
   auto monster_offset = CreateMonster(fbb, 0, 0, 0, fbb.CreateString("Fred"));
   fbb.Finish(monster_offset);
-  auto request = flatbuffers::BufferRef<Monster>(fbb.GetBufferPointer(),
-                                                 fbb.GetSize());
+  // Hand the buffer over to the BufferRef, such that GRPC can send it
+  // without making a copy.
+  auto size = fbb.GetSize();
+  auto request = flatbuffers::BufferRef<Monster>(fbb.ReleaseBufferPointer(),
+                                                 size);
   flatbuffers::BufferRef<Stat> response;
 
   // The actual RPC.
@@ -457,6 +457,82 @@ class simple_allocator {
   virtual void deallocate(uint8_t *p) const { delete[] p; }
 };
 
+// The allocator used by FlatBufferBuilder when none is given. It is shared,
+// since buffers released by a builder may outlive the builder itself.
+inline const simple_allocator &default_allocator() {
+  static simple_allocator allocator;
+  return allocator;
+}
+
+// An allocator that recycles buffers instead of returning them to the heap,
+// for services that create and release many builders in a steady stream.
+// It also tracks the largest allocation it has seen (the high-water mark),
+// and never hands out less than that: builders constructed with
+// high_water_mark() as their initial size don't need to grow.
+// This class is not thread-safe, and must outlive all builders and released
+// buffers that use it.
+class pooled_allocator : public simple_allocator {
+ public:
+  explicit pooled_allocator(size_t initial_size = 1024,
+                            size_t max_cached = 16)
+    : high_water_mark_(initial_size), max_cached_(max_cached) {}
+
+  virtual ~pooled_allocator() {
+    for (auto it = free_.begin(); it != free_.end(); ++it) delete[] *it;
+  }
+
+  // Pre-allocate buffers of high_water_mark() bytes, up to count in total.
+  void reserve(size_t count) {
+    count = (std::min)(count, max_cached_);
+    while (free_.size() < count) free_.push_back(new_block(high_water_mark_));
+  }
+
+  size_t high_water_mark() const { return high_water_mark_; }
+
+  // Number of buffers currently available for reuse.
+  size_t cached() const { return free_.size(); }
+
+  virtual uint8_t *allocate(size_t size) const {
+    if (size > high_water_mark_) high_water_mark_ = size;
+    // Blocks cached before the high-water mark last went up may be too
+    // small now; they won't be of use anymore, so drop them.
+    while (!free_.empty()) {
+      auto block = free_.back();
+      free_.pop_back();
+      if (capacity(block) >= size) return block + header_size;
+      delete[] block;
+    }
+    return new_block(high_water_mark_) + header_size;
+  }
+
+  virtual void deallocate(uint8_t *p) const {
+    auto block = p - header_size;
+    if (free_.size() < max_cached_ && capacity(block) >= high_water_mark_)
+      free_.push_back(block);
+    else
+      delete[] block;
+  }
+
+ private:
+  // Each block starts with its capacity, padded such that the memory we hand
+  // out stays aligned for any scalar.
+  static const size_t header_size = sizeof(largest_scalar_t);
+
+  static uint8_t *new_block(size_t size) {
+    auto block = new uint8_t[header_size + size];
+    *reinterpret_cast<size_t *>(block) = size;
+    return block;
+  }
+
+  static size_t capacity(const uint8_t *block) {
+    return *reinterpret_cast<const size_t *>(block);
+  }
+
+  mutable size_t high_water_mark_;
+  size_t max_cached_;
+  mutable std::vector<uint8_t *> free_;
+};
+
 // This is a minimal replication of std::vector<uint8_t> functionality,
 // except growing from higher to lower addresses. i.e push_back() inserts data
 // in the lowest address in the vector.
@@ -484,11 +560,20 @@ class vector_downward {
   }
 
   #ifndef FLATBUFFERS_CPP98_STL
+  // The deleter of pointers returned by release(). Besides deallocating from
+  // the start of the allocated memory, it remembers the size of the
+  // allocation, such that reset() can take it back.
+  struct releaser {
+    const simple_allocator *allocator;
+    uint8_t *buf;
+    size_t reserved;
+    void operator()(uint8_t *) const { allocator->deallocate(buf); }
+  };
+
   // Relinquish the pointer to the caller.
+  // The allocator must outlive the returned pointer.
   unique_ptr_t release() {
-    // Actually deallocate from the start of the allocated memory.
-    std::function<void(uint8_t *)> deleter(
-      std::bind(&simple_allocator::deallocate, allocator_, buf_));
+    releaser deleter = { &allocator_, buf_, reserved_ };
 
     // Point to the desired offset.
     unique_ptr_t retval(data(), deleter);
@@ -499,6 +584,24 @@ class vector_downward {
 
     return retval;
   }
+
+  // Take ownership of memory previously returned by release(), to use it
+  // instead of our current buffer. This only works if it was released by a
+  // vector_downward with the same allocator; otherwise it is deallocated, and
+  // false is returned.
+  bool reset(unique_ptr_t &&released) {
+    auto r = released.get_deleter().target<releaser>();
+    if (!r || r->allocator != &allocator_) {
+      released.reset();
+      return false;
+    }
+    if (buf_) allocator_.deallocate(buf_);
+    buf_ = r->buf;
+    reserved_ = r->reserved;
+    cur_ = buf_ + reserved_;
+    released.release();
+    return true;
+  }
   #endif
 
   size_t growth_policy(size_t bytes) {
@@ -605,28 +708,33 @@ FLATBUFFERS_FINAL_CLASS
   /// be used.
   explicit FlatBufferBuilder(uoffset_t initial_size = 1024,
                              const simple_allocator *allocator = nullptr)
-      : buf_(initial_size, allocator ? *allocator : default_allocator),
-        nested(false), finished(false), minalign_(1), force_defaults_(false),
-        string_pool(nullptr) {
+      : buf_(initial_size, allocator ? *allocator : default_allocator()),
+        nested(false), finished(false), num_vtables_(0),
+        max_vtables_(~static_cast<size_t>(0)), vtable_hits_(0),
+        vtable_misses_(0), minalign_(1), force_defaults_(false),
+        num_pooled_strings_(0) {
     offsetbuf_.reserve(16);  // Avoid first few reallocs.
-    vtables_.reserve(16);
     EndianCheck();
   }
 
-  ~FlatBufferBuilder() {
-    if (string_pool) delete string_pool;
-  }
-
   /// @brief Reset all the state in this FlatBufferBuilder so it can be reused
-  /// to construct another buffer.
+  /// to construct another buffer. This keeps the memory allocated for the
+  /// buffer and the vtable and string pools, so building similar buffers
+  /// repeatedly does not allocate.
   void Clear() {
     buf_.clear();
     offsetbuf_.clear();
     nested = false;
     finished = false;
-    vtables_.clear();
+    if (num_vtables_) {
+      std::fill(vtables_.begin(), vtables_.end(), HashedOffset());
+      num_vtables_ = 0;
+    }
     minalign_ = 1;
-    if (string_pool) string_pool->clear();
+    if (num_pooled_strings_) {
+      std::fill(string_pool_.begin(), string_pool_.end(), HashedOffset());
+      num_pooled_strings_ = 0;
+    }
   }
 
   /// @brief The current size of the serialized buffer, counting from the end.
@@ -647,15 +755,30 @@ FLATBUFFERS_FINAL_CLASS
 
   #ifndef FLATBUFFERS_CPP98_STL
   /// @brief Get the released pointer to the serialized buffer.
-  /// @warning Do NOT attempt to use this FlatBufferBuilder afterwards!
+  /// @warning Call `Clear()` or `Reset()` before using this FlatBufferBuilder
+  /// again.
   /// @return The `unique_ptr` returned has a special allocator that knows how
   /// to deallocate this pointer (since it points to the middle of an
   /// allocation). Thus, do not mix this pointer with other `unique_ptr`'s, or
-  /// call `release()`/`reset()` on it.
+  /// call `release()`/`reset()` on it. If you supplied your own allocator
+  /// to this FlatBufferBuilder, it must outlive this pointer.
   unique_ptr_t ReleaseBufferPointer() {
     Finished();
     return buf_.release();
   }
+
+  /// @brief Reset all the state like `Clear()`, but reuse the memory of a
+  /// buffer previously returned by `ReleaseBufferPointer()` rather than
+  /// allocating a new one.
+  /// @param[in] buf The released buffer, which must no longer be in use. Its
+  /// memory can only be reused if it was released by a FlatBufferBuilder with
+  /// the same allocator; otherwise it is deallocated.
+  /// @return Returns `true` if the memory of `buf` was reused.
+  bool Reset(unique_ptr_t &&buf) {
+    auto reused = buf_.reset(std::move(buf));
+    Clear();
+    return reused;
+  }
   #endif
 
   /// @cond FLATBUFFERS_INTERNAL
@@ -674,6 +797,22 @@ FLATBUFFERS_FINAL_CLASS
   /// @param[in] bool fd When set to `true`, always serializes default values.
   void ForceDefaults(bool fd) { force_defaults_ = fd; }
 
+  /// @brief Limit how many distinct vtables are remembered for
+  /// deduplication. Tables whose vtable isn't among them get a vtable of
+  /// their own, so this trades buffer size for builder memory when building
+  /// buffers with very many different table layouts.
+  /// @param[in] max_vtables The maximum number of vtables to remember.
+  /// Defaults to unlimited, `0` turns off vtable deduplication.
+  void SetVTableCacheLimit(size_t max_vtables) { max_vtables_ = max_vtables; }
+
+  /// @brief The number of tables (since this builder was constructed) that
+  /// could share the vtable of an earlier table.
+  size_t GetVTableCacheHits() const { return vtable_hits_; }
+
+  /// @brief The number of tables (since this builder was constructed) that
+  /// had to write a new vtable.
+  size_t GetVTableCacheMisses() const { return vtable_misses_; }
+
   /// @cond FLATBUFFERS_INTERNAL
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
@@ -717,6 +856,32 @@ FLATBUFFERS_FINAL_CLASS
     return PushElement(ReferTo(off.o));
   }
 
+  // Write all elements of a vector at once, after StartVector().
+  template<typename T> void PushElements(const T *elements, size_t len) {
+    AssertScalarT<T>();
+    Align(sizeof(T));  // StartVector() already aligned, this sets minalign_.
+    auto dest = buf_.make_space(len * sizeof(T));
+    #if FLATBUFFERS_LITTLEENDIAN
+      // Memory layout is the same as the wire format.
+      memcpy(dest, elements, len * sizeof(T));
+    #else
+      for (size_t i = 0; i < len; i++)
+        WriteScalar(dest + i * sizeof(T), elements[i]);
+    #endif
+  }
+
+  template<typename T> void PushElements(const Offset<T> *elements,
+                                         size_t len) {
+    Align(sizeof(uoffset_t));
+    auto dest = buf_.make_space(len * sizeof(uoffset_t));
+    // Each offset is relative to its own location, see ReferTo below.
+    auto loc = GetSize();
+    for (size_t i = 0; i < len; i++, loc -= sizeof(uoffset_t)) {
+      assert(elements[i].o && elements[i].o < loc);
+      WriteScalar(dest + i * sizeof(uoffset_t), loc - elements[i].o);
+    }
+  }
+
   // When writing fields, we track where they are, so we can create correct
   // vtables later.
   void TrackField(voffset_t field, uoffset_t off) {
@@ -811,17 +976,32 @@ FLATBUFFERS_FINAL_CLASS
     auto vt_use = GetSize();
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
-    for (auto it = vtables_.begin(); it != vtables_.end(); ++it) {
-      auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
-      auto vt2_size = *vt2;
-      if (vt1_size != vt2_size || memcmp(vt2, vt1, vt1_size)) continue;
-      vt_use = *it;
+    if (vtables_.empty()) vtables_.resize(32);
+    auto hash = HashBytes(vt1, vt1_size, 0);
+    auto mask = vtables_.size() - 1;
+    auto slot = hash & mask;
+    for (; vtables_[slot].off; slot = (slot + 1) & mask) {
+      if (vtables_[slot].hash != hash) continue;
+      auto vt2 = reinterpret_cast<voffset_t *>(
+                   buf_.data_at(vtables_[slot].off));
+      if (vt1_size != ReadScalar<voffset_t>(vt2) || memcmp(vt2, vt1, vt1_size))
+        continue;
+      vt_use = vtables_[slot].off;
       buf_.pop(GetSize() - vtableoffsetloc);
       break;
     }
-    // If this is a new vtable, remember it.
     if (vt_use == GetSize()) {
-      vtables_.push_back(vt_use);
+      vtable_misses_++;
+      // If this is a new vtable, remember it (unless we're at the limit).
+      if (num_vtables_ < max_vtables_) {
+        vtables_[slot].off = vt_use;
+        vtables_[slot].hash = hash;
+        // Keep the load factor at most 1/2, such that probe sequences stay
+        // short.
+        if (++num_vtables_ * 2 > vtables_.size()) GrowHashTable(vtables_);
+      }
+    } else {
+      vtable_hits_++;
     }
     // Fill the vtable offset we created above.
     // The offset points from the beginning of the object to where the
@@ -908,21 +1088,24 @@ FLATBUFFERS_FINAL_CLASS
   /// @param[in] len The number of bytes that should be stored from `str`.
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const char *str, size_t len) {
-    if (!string_pool)
-      string_pool = new StringOffsetMap(StringOffsetCompare(buf_));
-    auto size_before_string = buf_.size();
-    // Must first serialize the string, since the set is all offsets into
-    // buffer.
-    auto off = CreateString(str, len);
-    auto it = string_pool->find(off);
-    // If it exists we reuse existing serialized data!
-    if (it != string_pool->end()) {
-      // We can remove the string we serialized.
-      buf_.pop(buf_.size() - size_before_string);
-      return *it;
+    if (string_pool_.empty()) string_pool_.resize(32);
+    auto hash = HashBytes(str, len, static_cast<uint32_t>(len));
+    auto mask = string_pool_.size() - 1;
+    auto slot = hash & mask;
+    for (; string_pool_[slot].off; slot = (slot + 1) & mask) {
+      if (string_pool_[slot].hash != hash) continue;
+      auto pooled = reinterpret_cast<const String *>(
+                      buf_.data_at(string_pool_[slot].off));
+      // If it exists we reuse existing serialized data!
+      if (pooled->size() == len && !memcmp(pooled->c_str(), str, len))
+        return Offset<String>(string_pool_[slot].off);
     }
     // Record this string for future use.
-    string_pool->insert(off);
+    auto off = CreateString(str, len);
+    string_pool_[slot].off = off.o;
+    string_pool_[slot].hash = hash;
+    if (++num_pooled_strings_ * 2 > string_pool_.size())
+      GrowHashTable(string_pool_);
     return off;
   }
 
@@ -990,9 +1173,7 @@ FLATBUFFERS_FINAL_CLASS
   /// where the vector is stored.
   template<typename T> Offset<Vector<T>> CreateVector(const T *v, size_t len) {
     StartVector(len, sizeof(T));
-    for (auto i = len; i > 0; ) {
-      PushElement(v[--i]);
-    }
+    if (len) PushElements(v, len);
     return Offset<Vector<T>>(EndVector(len));
   }
 
@@ -1011,9 +1192,8 @@ FLATBUFFERS_FINAL_CLASS
   // Background: https://isocpp.org/blog/2012/11/on-vectorbool
   Offset<Vector<uint8_t>> CreateVector(const std::vector<bool> &v) {
     StartVector(v.size(), sizeof(uint8_t));
-    for (auto i = v.size(); i > 0; ) {
-      PushElement(static_cast<uint8_t>(v[--i]));
-    }
+    auto dest = buf_.make_space(v.size());
+    for (size_t i = 0; i < v.size(); i++) dest[i] = static_cast<uint8_t>(v[i]);
     return Offset<Vector<uint8_t>>(EndVector(v.size()));
   }
 
@@ -1056,7 +1236,7 @@ FLATBUFFERS_FINAL_CLASS
   template<typename T> Offset<Vector<const T *>> CreateVectorOfStructs(
       const T *v, size_t len) {
     StartVector(len * sizeof(T) / AlignOf<T>(), AlignOf<T>());
-    PushBytes(reinterpret_cast<const uint8_t *>(v), sizeof(T) * len);
+    if (len) memcpy(buf_.make_space(sizeof(T) * len), v, sizeof(T) * len);
     return Offset<Vector<const T *>>(EndVector(len));
   }
 
@@ -1153,20 +1333,37 @@ FLATBUFFERS_FINAL_CLASS
   /// will be prefixed with a standard FlatBuffers file header.
   template<typename T> void Finish(Offset<T> root,
                                    const char *file_identifier = nullptr) {
+    Finish(root.o, file_identifier, false);
+  }
+
+  /// @brief Finish serializing a buffer like `Finish()`, and prefix it with
+  /// its size. This allows storing or sending a sequence of buffers back to
+  /// back (see `SizePrefixedBufferReader` in util.h). Read the buffer with
+  /// `GetSizePrefixedRoot()`.
+  /// @param[in] file_identifier If a `file_identifier` is given, the buffer
+  /// will be prefixed with a standard FlatBuffers file header (following the
+  /// size).
+  template<typename T> void FinishSizePrefixed(Offset<T> root,
+                                     const char *file_identifier = nullptr) {
+    Finish(root.o, file_identifier, true);
+  }
+
+ private:
+  void Finish(uoffset_t root, const char *file_identifier, bool size_prefix) {
     NotNested();
     // This will cause the whole buffer to be aligned.
-    PreAlign(sizeof(uoffset_t) + (file_identifier ? kFileIdentifierLength : 0),
-             minalign_);
+    PreAlign((size_prefix ? sizeof(uoffset_t) : 0) + sizeof(uoffset_t) +
+             (file_identifier ? kFileIdentifierLength : 0), minalign_);
     if (file_identifier) {
       assert(strlen(file_identifier) == kFileIdentifierLength);
       buf_.push(reinterpret_cast<const uint8_t *>(file_identifier),
                 kFileIdentifierLength);
     }
-    PushElement(ReferTo(root.o));  // Location of root.
+    PushElement(ReferTo(root));  // Location of root.
+    if (size_prefix) PushElement(GetSize());
     finished = true;
   }
 
- private:
   // You shouldn't really be copying instances of this class.
   FlatBufferBuilder(const FlatBufferBuilder &);
   FlatBufferBuilder &operator=(const FlatBufferBuilder &);
@@ -1176,8 +1373,6 @@ FLATBUFFERS_FINAL_CLASS
     voffset_t id;
   };
 
-  simple_allocator default_allocator;
-
   vector_downward buf_;
 
   // Accumulating offsets of table members while it is being built.
@@ -1189,26 +1384,53 @@ FLATBUFFERS_FINAL_CLASS
   // Ensure the buffer is finished before it is being accessed.
   bool finished;
 
-  std::vector<uoffset_t> vtables_;  // todo: Could make this into a map?
+  // An entry in the open addressing hash tables below, which find earlier
+  // serialized data with the same contents in constant time.
+  // Empty slots have an offset of 0, which no object can have.
+  struct HashedOffset {
+    HashedOffset() : off(0), hash(0) {}
+    uoffset_t off;
+    uint32_t hash;
+  };
+
+  // FNV-1a.
+  static uint32_t HashBytes(const void *data, size_t len, uint32_t seed) {
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+    uint32_t hash = 0x811C9DC5 ^ seed;
+    for (size_t i = 0; i < len; i++) {
+      hash ^= bytes[i];
+      hash *= 0x01000193;
+    }
+    return hash;
+  }
+
+  // Doubles the size of a table, which must always be a power of 2.
+  static void GrowHashTable(std::vector<HashedOffset> &table) {
+    std::vector<HashedOffset> old(table.size() * 2);
+    old.swap(table);
+    auto mask = table.size() - 1;
+    for (auto it = old.begin(); it != old.end(); ++it) {
+      if (!it->off) continue;
+      auto slot = it->hash & mask;
+      while (table[slot].off) slot = (slot + 1) & mask;
+      table[slot] = *it;
+    }
+  }
+
+  // The vtables written so far, for EndTable() to share them.
+  std::vector<HashedOffset> vtables_;
+  size_t num_vtables_;
+  size_t max_vtables_;
+  size_t vtable_hits_;
+  size_t vtable_misses_;
 
   size_t minalign_;
 
   bool force_defaults_;  // Serialize values equal to their defaults anyway.
 
-  struct StringOffsetCompare {
-    StringOffsetCompare(const vector_downward &buf) : buf_(&buf) {}
-    bool operator() (const Offset<String> &a, const Offset<String> &b) const {
-      auto stra = reinterpret_cast<const String *>(buf_->data_at(a.o));
-      auto strb = reinterpret_cast<const String *>(buf_->data_at(b.o));
-      return strncmp(stra->c_str(), strb->c_str(),
-                     std::min(stra->size(), strb->size()) + 1) < 0;
-    }
-    const vector_downward *buf_;
-  };
-
-  // For use with CreateSharedString. Instantiated on first use only.
-  typedef std::set<Offset<String>, StringOffsetCompare> StringOffsetMap;
-  StringOffsetMap *string_pool;
+  // For use with CreateSharedString. Allocated on first use only.
+  std::vector<HashedOffset> string_pool_;
+  size_t num_pooled_strings_;
 };
 /// @}
 
@@ -1224,6 +1446,17 @@ template<typename T> const T *GetRoot(const void *buf) {
   return GetMutableRoot<T>(const_cast<void *>(buf));
 }
 
+// The same for buffers finished with FlatBufferBuilder::FinishSizePrefixed().
+template<typename T> const T *GetSizePrefixedRoot(const void *buf) {
+  return GetRoot<T>(reinterpret_cast<const uint8_t *>(buf) + sizeof(uoffset_t));
+}
+
+// The size of a buffer finished with FlatBufferBuilder::FinishSizePrefixed(),
+// not counting the size prefix itself.
+inline uoffset_t GetPrefixedSize(const void *buf) {
+  return ReadScalar<uoffset_t>(buf);
+}
+
 /// Helpers to get a typed pointer to objects that are currently beeing built.
 /// @warning Creating new objects will lead to reallocations and invalidates
 /// the pointer!
@@ -1254,8 +1487,30 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
       , upper_bound_(buf)
     #endif
+    #ifndef FLATBUFFERS_CPP98_STL
+      , min_parallel_size_(0)
+    #endif
     {}
 
+  #ifndef FLATBUFFERS_CPP98_STL
+  // Runs task(0) .. task(count - 1), possibly in parallel, and returns when
+  // they are all done. See ThreadPool in thread_pool.h.
+  typedef std::function<void(size_t count,
+                             const std::function<void(size_t)> &task)>
+          ParallelFor;
+
+  // Verify vectors of tables with at least min_parallel_size elements in
+  // parallel, in chunks of that size, using parallel_for.
+  // The result (and GetComputedSize()) is the same as verifying serially,
+  // though the table limit passed to the constructor is only enforced per
+  // chunk while a vector is being verified, and on the total afterwards.
+  void SetParallelFor(const ParallelFor &parallel_for,
+                      size_t min_parallel_size = 1024) {
+    parallel_for_ = parallel_for;
+    min_parallel_size_ = (std::max)(min_parallel_size, static_cast<size_t>(1));
+  }
+  #endif
+
   // Central location where any verification failures register.
   bool Check(bool ok) const {
     #ifdef FLATBUFFERS_DEBUG_VERIFICATION_FAILURE
@@ -1341,6 +1596,10 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   // Special case for table contents, after the above has been called.
   template<typename T> bool VerifyVectorOfTables(const Vector<Offset<T>> *vec) {
     if (vec) {
+      #ifndef FLATBUFFERS_CPP98_STL
+        if (parallel_for_ && vec->size() >= min_parallel_size_)
+          return VerifyTablesInParallel(vec);
+      #endif
       for (uoffset_t i = 0; i < vec->size(); i++) {
         if (!vec->Get(i)->Verify(*this)) return false;
       }
@@ -1350,19 +1609,17 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
   // Verify this whole buffer, starting with root type T.
   template<typename T> bool VerifyBuffer(const char *identifier) {
-    if (identifier && (size_t(end_ - buf_) < 2 * sizeof(flatbuffers::uoffset_t) ||
-                       !BufferHasIdentifier(buf_, identifier))) {
-      return false;
-    }
+    return VerifyBufferFrom<T>(buf_, identifier);
+  }
 
-    // Call T::Verify, which must be in the generated code for this type.
-    return Verify<uoffset_t>(buf_) &&
-      reinterpret_cast<const T *>(buf_ + ReadScalar<uoffset_t>(buf_))->
-        Verify(*this)
-        #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
-          && GetComputedSize()
-        #endif
-            ;
+  // Verify a buffer finished with FlatBufferBuilder::FinishSizePrefixed().
+  // Data beyond the size in the prefix is not part of it.
+  template<typename T> bool VerifySizePrefixedBuffer(const char *identifier) {
+    if (!Verify<uoffset_t>(buf_)) return false;
+    auto size = GetPrefixedSize(buf_);
+    if (!Check(size <= size_t(end_ - buf_) - sizeof(uoffset_t))) return false;
+    end_ = buf_ + sizeof(uoffset_t) + size;
+    return VerifyBufferFrom<T>(buf_ + sizeof(uoffset_t), identifier);
   }
 
   // Called at the start of a table to increase counters measuring data
@@ -1392,6 +1649,58 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   #endif
 
  private:
+  #ifndef FLATBUFFERS_CPP98_STL
+  template<typename T> bool VerifyTablesInParallel(
+      const Vector<Offset<T>> *vec) {
+    // Each chunk gets a verifier of its own, starting from our state.
+    // Afterwards, we merge their counters back into ours.
+    auto num_chunks = (vec->size() + min_parallel_size_ - 1) /
+                      min_parallel_size_;
+    std::vector<Verifier> chunks(num_chunks, *this);
+    for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+      it->num_tables_ = 0;
+      it->max_tables_ = max_tables_ - num_tables_;
+    }
+    std::vector<uint8_t> ok(num_chunks, 0);
+    parallel_for_(num_chunks, [&](size_t chunk) {
+      auto &verifier = chunks[chunk];
+      auto end = (std::min)((chunk + 1) * min_parallel_size_,
+                            static_cast<size_t>(vec->size()));
+      for (auto i = chunk * min_parallel_size_; i < end; i++) {
+        if (!vec->Get(static_cast<uoffset_t>(i))->Verify(verifier)) return;
+      }
+      ok[chunk] = 1;
+    });
+    auto all_ok = true;
+    for (size_t i = 0; i < num_chunks; i++) {
+      all_ok = all_ok && ok[i];
+      num_tables_ += chunks[i].num_tables_;
+      #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+        if (upper_bound_ < chunks[i].upper_bound_)
+          upper_bound_ = chunks[i].upper_bound_;
+      #endif
+    }
+    return Check(all_ok && num_tables_ <= max_tables_);
+  }
+  #endif
+
+  template<typename T> bool VerifyBufferFrom(const uint8_t *start,
+                                             const char *identifier) {
+    if (identifier && (size_t(end_ - start) < 2 * sizeof(uoffset_t) ||
+                       !BufferHasIdentifier(start, identifier))) {
+      return false;
+    }
+
+    // Call T::Verify, which must be in the generated code for this type.
+    return Verify<uoffset_t>(start) &&
+      reinterpret_cast<const T *>(start + ReadScalar<uoffset_t>(start))->
+        Verify(*this)
+        #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
+          && GetComputedSize()
+        #endif
+            ;
+  }
+
   const uint8_t *buf_;
   const uint8_t *end_;
   size_t depth_;
@@ -1401,17 +1710,32 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
   mutable const uint8_t *upper_bound_;
   #endif
+  #ifndef FLATBUFFERS_CPP98_STL
+  ParallelFor parallel_for_;
+  size_t min_parallel_size_;
+  #endif
 };
 
 // Convenient way to bundle a buffer and its length, to pass it around
 // typed by its root.
-// A BufferRef does not own its buffer.
+// A BufferRef does not own its buffer, unless it was constructed from a
+// released buffer (or by a transport, see grpc.h), in which case copies of
+// the BufferRef share ownership of it.
 struct BufferRefBase {};  // for std::is_base_of
 template<typename T> struct BufferRef : BufferRefBase {
   BufferRef() : buf(nullptr), len(0), must_free(false) {}
   BufferRef(uint8_t *_buf, uoffset_t _len)
     : buf(_buf), len(_len), must_free(false) {}
 
+  #ifndef FLATBUFFERS_CPP98_STL
+  // Take ownership of a buffer returned by
+  // FlatBufferBuilder::ReleaseBufferPointer(). This allows transports to
+  // hold on to the data without copying it.
+  BufferRef(unique_ptr_t &&_buf, uoffset_t _len)
+    : buf(_buf.get()), len(_len), must_free(false),
+      owner(_buf.release(), _buf.get_deleter()) {}
+  #endif
+
   ~BufferRef() { if (must_free) free(buf); }
 
   const T *GetRoot() const { return flatbuffers::GetRoot<T>(buf); }
@@ -1424,6 +1748,11 @@ template<typename T> struct BufferRef : BufferRefBase {
   uint8_t *buf;
   uoffset_t len;
   bool must_free;
+  #ifndef FLATBUFFERS_CPP98_STL
+  // Keeps the memory buf points into alive, if set. Shared, such that it can
+  // be handed to a transport that outlives this BufferRef.
+  std::shared_ptr<void> owner;
+  #endif
 };
 
 // "structs" are flat structures that do not have an offset table, thus
@@ -19,9 +19,124 @@
 
 // Helper functionality to glue FlatBuffers and GRPC.
 
+#include <mutex>
+#include <vector>
+
 #include "grpc++/support/byte_buffer.h"
 #include "grpc/byte_buffer_reader.h"
 
+namespace flatbuffers {
+
+// A thread-safe cache of the memory blocks that back outgoing slices.
+// Blocks come back here when GRPC is done sending them (or when a builder
+// grows out of them), so a steady stream of messages of similar size runs
+// without allocating, and memory use stays bounded by max_cached_blocks.
+// The pool must outlive all builders and messages that use it.
+class SlicePool {
+ public:
+  explicit SlicePool(size_t max_cached_blocks = 64)
+    : max_cached_blocks_(max_cached_blocks) {}
+
+  ~SlicePool() {
+    for (auto it = free_.begin(); it != free_.end(); ++it) delete[] *it;
+  }
+
+  // Get a block of at least size bytes, reusing a cached one if possible.
+  uint8_t *Acquire(size_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Pick the smallest cached block that fits. The cache is small, so a
+      // linear scan is fine.
+      auto best = free_.end();
+      for (auto it = free_.begin(); it != free_.end(); ++it) {
+        if (Capacity(*it) >= size &&
+            (best == free_.end() || Capacity(*it) < Capacity(*best)))
+          best = it;
+      }
+      if (best != free_.end()) {
+        auto block = *best;
+        *best = free_.back();
+        free_.pop_back();
+        return block + kHeaderSize;
+      }
+    }
+    auto block = new uint8_t[kHeaderSize + size];
+    *reinterpret_cast<size_t *>(block) = size;
+    return block + kHeaderSize;
+  }
+
+  // Give back a pointer obtained from Acquire().
+  void Release(uint8_t *p) {
+    auto block = p - kHeaderSize;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_.size() < max_cached_blocks_) {
+        free_.push_back(block);
+        return;
+      }
+    }
+    delete[] block;
+  }
+
+  // Number of blocks currently available for reuse.
+  size_t CachedBlocks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+  }
+
+ private:
+  // Each block starts with its capacity, padded such that the memory we
+  // hand out stays aligned for any scalar.
+  static const size_t kHeaderSize = sizeof(largest_scalar_t);
+
+  static size_t Capacity(const uint8_t *block) {
+    return *reinterpret_cast<const size_t *>(block);
+  }
+
+  size_t max_cached_blocks_;
+  std::vector<uint8_t *> free_;
+  std::mutex mutex_;
+};
+
+// Allocator that backs a FlatBufferBuilder with memory from a SlicePool.
+// Combined with ReleaseBufferRef() below, finished messages are handed to
+// GRPC as slices without being copied, and their memory is recycled once
+// GRPC has sent them.
+class SliceAllocator : public simple_allocator {
+ public:
+  explicit SliceAllocator(SlicePool &pool) : pool_(pool) {}
+
+  virtual uint8_t *allocate(size_t size) const { return pool_.Acquire(size); }
+  virtual void deallocate(uint8_t *p) const { pool_.Release(p); }
+
+ private:
+  SlicePool &pool_;
+};
+
+// Moves the finished buffer out of fbb into a BufferRef that owns it.
+// Sending that BufferRef through GRPC does not copy it (see Serialize()
+// below). fbb can be used for the next message after calling Clear().
+template<typename T> BufferRef<T> ReleaseBufferRef(FlatBufferBuilder &fbb) {
+  auto size = fbb.GetSize();
+  return BufferRef<T>(fbb.ReleaseBufferPointer(), size);
+}
+
+namespace grpc_internal {
+
+// Called by GRPC when the last reference to an outgoing slice goes away.
+inline void UnrefOwner(void *owner) {
+  delete reinterpret_cast<std::shared_ptr<void> *>(owner);
+}
+
+// Keeps an incoming slice alive for as long as a BufferRef points into it.
+inline void UnrefSlice(gpr_slice *slice) {
+  gpr_slice_unref(*slice);
+  delete slice;
+}
+
+}  // namespace grpc_internal
+}  // namespace flatbuffers
+
 namespace grpc {
 
 template <class T>
@@ -30,37 +145,83 @@ class SerializationTraits<T, typename std::enable_if<std::is_base_of<
  public:
   // The type we're passing here is a BufferRef, which is already serialized
   // FlatBuffer data, which then gets passed to GRPC.
+  // If the BufferRef owns its data (e.g. it was constructed from
+  // FlatBufferBuilder::ReleaseBufferPointer()), the slice we hand to GRPC
+  // shares that ownership, and no copy is made. Otherwise we can't know how
+  // long the data stays valid, so we have to copy it.
   static grpc::Status Serialize(const T& msg,
                                 grpc_byte_buffer **buffer,
                                 bool *own_buffer) {
-    // TODO(wvo): make this work without copying.
-    auto slice = gpr_slice_from_copied_buffer(
-                   reinterpret_cast<const char *>(msg.buf), msg.len);
+    gpr_slice slice;
+    if (msg.owner) {
+      slice = gpr_slice_new_with_user_data(
+                msg.buf, msg.len, flatbuffers::grpc_internal::UnrefOwner,
+                new std::shared_ptr<void>(msg.owner));
+    } else {
+      slice = gpr_slice_from_copied_buffer(
+                reinterpret_cast<const char *>(msg.buf), msg.len);
+    }
     *buffer = grpc_raw_byte_buffer_create(&slice, 1);
+    gpr_slice_unref(slice);  // The byte buffer holds its own reference.
     *own_buffer = true;
     return grpc::Status();
   }
 
   // There is no de-serialization step in FlatBuffers, so we just receive
   // the data from GRPC.
+  // The common case is for a message to arrive in a single slice, which we
+  // then reference in place. If it is split over multiple slices (or the
+  // slice is not suitably aligned to read a FlatBuffer from), we fall back
+  // to concatenating the data into a single allocation.
   static grpc::Status Deserialize(grpc_byte_buffer *buffer,
                                   T *msg,
                                   int max_message_size) {
-    // TODO(wvo): make this more efficient / zero copy when possible.
     auto len = grpc_byte_buffer_length(buffer);
-    msg->buf = reinterpret_cast<uint8_t *>(malloc(len));
-    msg->len = static_cast<flatbuffers::uoffset_t>(len);
-    msg->must_free = true;
-    uint8_t *current = msg->buf;
     grpc_byte_buffer_reader reader;
     grpc_byte_buffer_reader_init(&reader, buffer);
-    gpr_slice slice;
-    while (grpc_byte_buffer_reader_next(&reader, &slice)) {
-      memcpy(current, GPR_SLICE_START_PTR(slice), GPR_SLICE_LENGTH(slice));
-      current += GPR_SLICE_LENGTH(slice);
-      gpr_slice_unref(slice);
+    gpr_slice first, slice;
+    bool has_first = grpc_byte_buffer_reader_next(&reader, &first) != 0;
+    bool has_more = has_first &&
+                    grpc_byte_buffer_reader_next(&reader, &slice) != 0;
+    if (msg->must_free) free(msg->buf);
+    msg->must_free = false;
+    msg->owner.reset();
+    msg->len = static_cast<flatbuffers::uoffset_t>(len);
+    if (has_first && !has_more) {
+      // Move the slice to the heap first: small slices are stored inline in
+      // the gpr_slice struct itself, so this keeps their address stable.
+      auto owned = new gpr_slice(first);
+      auto start = GPR_SLICE_START_PTR(*owned);
+      msg->owner = std::shared_ptr<void>(owned,
+                                         flatbuffers::grpc_internal::UnrefSlice);
+      if ((reinterpret_cast<uintptr_t>(start) &
+           (sizeof(flatbuffers::largest_scalar_t) - 1)) == 0) {
+        msg->buf = start;
+      } else {
+        msg->buf = reinterpret_cast<uint8_t *>(malloc(len));
+        msg->must_free = true;
+        memcpy(msg->buf, start, len);
+        msg->owner.reset();
+      }
+    } else {
+      msg->buf = reinterpret_cast<uint8_t *>(malloc(len));
+      msg->must_free = true;
+      uint8_t *current = msg->buf;
+      if (has_first) {
+        memcpy(current, GPR_SLICE_START_PTR(first), GPR_SLICE_LENGTH(first));
+        current += GPR_SLICE_LENGTH(first);
+        gpr_slice_unref(first);
+        memcpy(current, GPR_SLICE_START_PTR(slice), GPR_SLICE_LENGTH(slice));
+        current += GPR_SLICE_LENGTH(slice);
+        gpr_slice_unref(slice);
+        while (grpc_byte_buffer_reader_next(&reader, &slice)) {
+          memcpy(current, GPR_SLICE_START_PTR(slice), GPR_SLICE_LENGTH(slice));
+          current += GPR_SLICE_LENGTH(slice);
+          gpr_slice_unref(slice);
+        }
+      }
+      GPR_ASSERT(current == msg->buf + msg->len);
     }
-    GPR_ASSERT(current == msg->buf + msg->len);
     grpc_byte_buffer_reader_destroy(&reader);
     grpc_byte_buffer_destroy(buffer);
     return grpc::Status();
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <stack>
+#include <unordered_map>
 #include <memory>
 #include <functional>
 
@@ -134,6 +135,8 @@ struct Type {
 
   Offset<reflection::Type> Serialize(FlatBufferBuilder *builder) const;
 
+  bool Deserialize(const Parser &parser, const reflection::Type *type);
+
   BaseType base_type;
   BaseType element;       // only set if t == BASE_TYPE_VECTOR
   StructDef *struct_def;  // only set if t or element == BASE_TYPE_STRUCT
@@ -142,16 +145,29 @@ struct Type {
 };
 
 // Represents a parsed scalar value, it's type, and field offset.
+// Besides its text in `constant`, a value has a binary form in `typed`:
+// values parsed from JSON data only have the latter, so they don't need to
+// be converted to text and back before they are serialized. For the defaults
+// of scalar fields, both are set.
 struct Value {
   Value() : constant("0"), offset(static_cast<voffset_t>(
-                                ~(static_cast<voffset_t>(0U)))) {}
+                                ~(static_cast<voffset_t>(0U)))) {
+    typed.i = 0;
+  }
   Type type;
   std::string constant;
   voffset_t offset;
+  union {
+    int64_t i;    // Integer and bool scalars.
+    double f;     // Floating point scalars.
+    uoffset_t o;  // Strings, vectors, tables and unions.
+    size_t s;     // Structs: where their bytes start in the parser's
+                  // struct_stack_.
+  } typed;
 };
 
 // Helper class that retains the original order of a set of identifiers and
-// also provides quick lookup.
+// also provides quick (hashed) lookup.
 template<typename T> class SymbolTable {
  public:
   ~SymbolTable() {
@@ -185,7 +201,7 @@ template<typename T> class SymbolTable {
   }
 
  public:
-  std::map<std::string, T *> dict;      // quick lookup
+  std::unordered_map<std::string, T *> dict;  // quick lookup
   std::vector<T *> vec;  // Used to iterate in order of insertion
 };
 
@@ -211,6 +227,9 @@ struct Definition {
       SerializeAttributes(FlatBufferBuilder *builder,
                           const Parser &parser) const;
 
+  bool DeserializeAttributes(Parser &parser,
+                             const Vector<Offset<reflection::KeyValue>> *attrs);
+
   std::string name;
   std::string file;
   std::vector<std::string> doc_comment;
@@ -229,6 +248,8 @@ struct FieldDef : public Definition {
   Offset<reflection::Field> Serialize(FlatBufferBuilder *builder, uint16_t id,
                                       const Parser &parser) const;
 
+  bool Deserialize(Parser &parser, const reflection::Field *field);
+
   Value value;
   bool deprecated; // Field is allowed to be present in old data, but can't be
                    // written in new data nor accessed in new code.
@@ -256,6 +277,8 @@ struct StructDef : public Definition {
   Offset<reflection::Object> Serialize(FlatBufferBuilder *builder,
                                        const Parser &parser) const;
 
+  bool Deserialize(Parser &parser, const reflection::Object *object);
+
   SymbolTable<FieldDef> fields;
   bool fixed;       // If it's struct, not a table.
   bool predecl;     // If it's used before it was defined.
@@ -283,6 +306,8 @@ struct EnumVal {
 
   Offset<reflection::EnumVal> Serialize(FlatBufferBuilder *builder) const;
 
+  bool Deserialize(const Parser &parser, const reflection::EnumVal *val);
+
   std::string name;
   std::vector<std::string> doc_comment;
   int64_t value;
@@ -290,11 +315,17 @@ struct EnumVal {
 };
 
 struct EnumDef : public Definition {
-  EnumDef() : is_union(false) {}
+  EnumDef() : is_union(false), dense_min_(0) {}
 
   EnumVal *ReverseLookup(int enum_idx, bool skip_union_default = true) {
-    for (auto it = vals.vec.begin() + static_cast<int>(is_union &&
-                                                       skip_union_default);
+    auto skip = is_union && skip_union_default;
+    if (dense_vals_.size()) {
+      auto i = static_cast<uint64_t>(static_cast<int64_t>(enum_idx)) -
+               static_cast<uint64_t>(dense_min_);
+      if (i >= dense_vals_.size()) return nullptr;
+      if (!skip || dense_vals_[i] != vals.vec.front()) return dense_vals_[i];
+    }
+    for (auto it = vals.vec.begin() + static_cast<int>(skip);
              it != vals.vec.end(); ++it) {
       if ((*it)->value == enum_idx) {
         return *it;
@@ -306,9 +337,20 @@ struct EnumDef : public Definition {
   Offset<reflection::Enum> Serialize(FlatBufferBuilder *builder,
                                      const Parser &parser) const;
 
+  bool Deserialize(Parser &parser, const reflection::Enum *_enum);
+
+  // Call once all values have been added. If they are close enough
+  // together, ReverseLookup() then finds them in a table indexed by value,
+  // rather than by searching.
+  void IndexValues();
+
   SymbolTable<EnumVal> vals;
   bool is_union;
   Type underlying_type;
+
+ private:
+  std::vector<EnumVal *> dense_vals_;  // By value - dense_min_, or empty.
+  int64_t dense_min_;
 };
 
 inline bool EqualByName(const Type &a, const Type &b) {
@@ -349,6 +391,9 @@ struct IDLOptions {
   bool generate_object_based_api;
   bool union_value_namespacing;
   bool allow_non_utf8;
+  bool binary_schema_builtins;
+  bool compact_json;
+  bool generate_json;
 
   // Possible options for the more general generator below.
   enum Language { kJava, kCSharp, kGo, kMAX };
@@ -372,17 +417,26 @@ struct IDLOptions {
       generate_object_based_api(false),
       union_value_namespacing(true),
       allow_non_utf8(false),
+      binary_schema_builtins(false),
+      compact_json(false),
+      generate_json(false),
       lang(IDLOptions::kJava) {}
 };
 
 // This encapsulates where the parser is in the current source file.
 struct ParserState {
-  ParserState() : cursor_(nullptr), line_(1), token_(-1) {}
+  ParserState()
+    : cursor_(nullptr), line_(1), token_(-1), replaying_(false),
+      replay_pos_(0) {}
 
  protected:
   const char *cursor_;
   int line_;  // the current line being parsed
   int token_;
+  // If set, tokens come from Parser::recorded_tokens_ starting at
+  // replay_pos_, rather than from the source.
+  bool replaying_;
+  size_t replay_pos_;
 
   std::string attribute_;
   std::vector<std::string> doc_comment_;
@@ -435,7 +489,9 @@ class Parser : public ParserState {
     : root_struct_def_(nullptr),
       opts(options),
       source_(nullptr),
+      source_end_(nullptr),
       anonymous_counter(0) {
+    schema_ = this;
     // Just in case none are declared:
     namespaces_.push_back(new Namespace());
     known_attributes_["deprecated"] = true;
@@ -452,6 +508,19 @@ class Parser : public ParserState {
     known_attributes_["idempotent"] = true;
   }
 
+  // Creates a parser for JSON data of the schema held by another parser,
+  // without copying or modifying that schema. It costs little more than a
+  // FlatBufferBuilder, so each thread can have its own, all sharing a single
+  // schema (which must outlive them, and must not be parsed into anymore).
+  // Parse() and ParseJsonStream() accept JSON only, and GenerateText() works
+  // with either parser. The schema is not visible through structs_ and
+  // enums_ of this parser, so don't use it to generate code.
+  Parser(const Parser &schema, const IDLOptions &options) : Parser(options) {
+    schema_ = &schema;
+    root_struct_def_ = schema.root_struct_def_;
+    file_identifier_ = schema.file_identifier_;
+  }
+
   ~Parser() {
     for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
       delete *it;
@@ -470,6 +539,26 @@ class Parser : public ParserState {
   bool Parse(const char *_source, const char **include_paths = nullptr,
              const char *source_filename = nullptr);
 
+  // As above, but for a source of the given length, which does not need to
+  // be 0-terminated. Nothing past length bytes is read.
+  bool ParseBuffer(const char *_source, size_t length,
+                   const char **include_paths = nullptr,
+                   const char *source_filename = nullptr);
+
+  // Called by ParseJsonStream() with each object, once it has been finished
+  // in builder_. Returning false stops parsing.
+  typedef std::function<bool(const FlatBufferBuilder &)> JsonObjectCallback;
+
+  // Parses a stream of JSON objects of the root type, such as newline
+  // delimited JSON, of the given length. Each object is parsed into builder_,
+  // reusing its memory, and then passed to callback. If size_prefixed, they
+  // are finished with FinishSizePrefixed(), such that they can be written
+  // out as a stream of buffers (see SizePrefixedFileWriter).
+  // Requires a schema with a root type to have been parsed before.
+  bool ParseJsonStream(const char *source, size_t length,
+                       const JsonObjectCallback &callback,
+                       bool size_prefixed = false);
+
   // Set the root type. May override the one set in the schema.
   bool SetRootType(const char *name);
 
@@ -485,6 +574,16 @@ class Parser : public ParserState {
   // See reflection/reflection.fbs
   void Serialize();
 
+  // The opposite of Serialize(): fills an empty parser with the definitions
+  // of a binary schema, which is a lot faster than parsing its source. The
+  // parser can then parse and generate JSON, or be shared (see above).
+  // Binary schemas lack doc comments, and only have the builtin attributes
+  // (such as "hash", needed to parse JSON) if they were serialized with
+  // opts.binary_schema_builtins.
+  // Verify untrusted buffers with reflection::VerifySchemaBuffer() first.
+  // Returns false if buf does not hold a consistent schema.
+  bool Deserialize(const uint8_t *buf);
+
   // Checks that the schema represented by this parser is a safe evolution
   // of the schema provided. Returns non-empty error on any problems.
   std::string ConformTo(const Parser &base);
@@ -493,7 +592,6 @@ class Parser : public ParserState {
 
 private:
   FLATBUFFERS_CHECKED_ERROR Error(const std::string &msg);
-  FLATBUFFERS_CHECKED_ERROR ParseHexNum(int nibbles, int64_t *val);
   FLATBUFFERS_CHECKED_ERROR Next();
   FLATBUFFERS_CHECKED_ERROR SkipByteOrderMark();
   bool Is(int t);
@@ -512,7 +610,7 @@ private:
                                           size_t parent_fieldn,
                                           const StructDef *parent_struct_def);
   FLATBUFFERS_CHECKED_ERROR ParseTable(const StructDef &struct_def,
-                                       std::string *value, uoffset_t *ovalue);
+                                       Value *value, uoffset_t *ovalue);
   void SerializeStruct(const StructDef &struct_def, const Value &val);
   void AddVector(bool sortbysize, int count);
   FLATBUFFERS_CHECKED_ERROR ParseVector(const Type &type, uoffset_t *ovalue);
@@ -521,7 +619,11 @@ private:
                                           BaseType req, bool *destmatch);
   FLATBUFFERS_CHECKED_ERROR ParseHash(Value &e, FieldDef* field);
   FLATBUFFERS_CHECKED_ERROR ParseSingleValue(Value &e);
+  FLATBUFFERS_CHECKED_ERROR ParseTypedScalar(Value &e);
+  FLATBUFFERS_CHECKED_ERROR ConstantToTyped(const char *s, Value &e);
   FLATBUFFERS_CHECKED_ERROR ParseEnumFromString(Type &type, int64_t *result);
+  Namespace *LookupCreateNamespace(const std::string &qualified_name,
+                                   std::string *name);
   StructDef *LookupCreateStruct(const std::string &name,
                                 bool create_if_new = true,
                                 bool definition = false);
@@ -542,7 +644,15 @@ private:
   FLATBUFFERS_CHECKED_ERROR SkipJsonObject();
   FLATBUFFERS_CHECKED_ERROR SkipJsonArray();
   FLATBUFFERS_CHECKED_ERROR SkipJsonString();
-  FLATBUFFERS_CHECKED_ERROR DoParse(const char *_source,
+  FLATBUFFERS_CHECKED_ERROR RecordJsonValue(size_t *start);
+  FLATBUFFERS_CHECKED_ERROR ParseRootTable(bool size_prefixed);
+  FLATBUFFERS_CHECKED_ERROR StartJson(const char *source, size_t length);
+  FLATBUFFERS_CHECKED_ERROR DoParseJson(const char *source, size_t length,
+                                        const char *source_filename);
+  FLATBUFFERS_CHECKED_ERROR DoParseJsonStream(
+      const char *source, size_t length, const JsonObjectCallback &callback,
+      bool size_prefixed);
+  FLATBUFFERS_CHECKED_ERROR DoParse(const char *_source, size_t length,
                                     const char **include_paths,
                                     const char *source_filename);
   FLATBUFFERS_CHECKED_ERROR CheckClash(std::vector<FieldDef*> &fields,
@@ -571,14 +681,102 @@ private:
 
  private:
   const char *source_;
+  const char *source_end_;  // Where source_ ends, it may not be 0 there.
+
+  // The character at cursor_ + i, or 0 past the end of the source.
+  char Peek(size_t i = 0) const {
+    return static_cast<size_t>(source_end_ - cursor_) > i ? cursor_[i] : 0;
+  }
+
+  // The parser that holds the schema: this one, or the one passed to the
+  // constructor above.
+  const Parser *schema_;
 
   std::string file_being_parsed_;
 
+  // A token as it was scanned from the source, see RecordJsonValue().
+  struct RecordedToken {
+    RecordedToken(int _token, int _line, const char *_cursor,
+                  const std::string &_attribute, size_t _end)
+      : token(_token), line(_line), cursor(_cursor), attribute(_attribute),
+        end(_end) {}
+
+    int token;
+    int line;
+    const char *cursor;
+    std::string attribute;
+    size_t end;  // Index of the token after the value this token starts.
+  };
+  std::vector<RecordedToken> recorded_tokens_;
+
   std::vector<std::pair<Value, FieldDef *>> field_stack_;
+  // Structs parsed from JSON, until they are serialized into their parent.
+  std::vector<uint8_t> struct_stack_;
 
   int anonymous_counter;
 };
 
+// Parses JSON data that arrives in pieces, e.g. as it is read from a socket
+// or pipe. Chunks are scanned as they come in and appended to a buffer, and
+// as soon as that holds the complete root object, it is parsed into
+// parser.builder_. Memory use thus grows with the largest single object: only
+// the text before and between objects is dropped.
+// The parser must have parsed a schema with a root type already.
+class ChunkedJsonParser {
+ public:
+  explicit ChunkedJsonParser(Parser &parser)
+    : parser_(parser), size_prefixed_(false), object_start_(0), scanned_(0),
+      depth_(0), quote_(0), escape_(false), comment_(kNoComment),
+      done_(false) {}
+
+  // Parses a stream of objects instead of a single one, passing each to
+  // callback as soon as it is complete (see Parser::ParseJsonStream()).
+  ChunkedJsonParser(Parser &parser,
+                    const Parser::JsonObjectCallback &callback,
+                    bool size_prefixed = false)
+    : parser_(parser), callback_(callback), size_prefixed_(size_prefixed),
+      object_start_(0), scanned_(0), depth_(0), quote_(0), escape_(false),
+      comment_(kNoComment), done_(false) {}
+
+  // Feeds the next length bytes of JSON text. Returns false on error, which
+  // is then described in parser.error_.
+  bool Feed(const char *chunk, size_t length);
+
+  // Call after feeding the last chunk. Returns false if the data did not
+  // contain a complete object (or ended in the middle of one, for streams).
+  bool Finish();
+
+  // Whether an object has been parsed into parser.builder_.
+  bool Done() const { return done_; }
+
+ private:
+  enum CommentState {
+    kNoComment,
+    kCommentStart,     // Seen a '/'.
+    kLineComment,
+    kBlockComment,
+    kBlockCommentEnd   // Seen a '*' in a block comment.
+  };
+
+  // Scans buffer_ from scanned_ onwards, setting *complete if it finds the
+  // end of the object. Returns false on error.
+  bool ScanObject(bool *complete);
+  bool Error(const std::string &msg);
+
+  Parser &parser_;
+  Parser::JsonObjectCallback callback_;  // Only set for streams.
+  bool size_prefixed_;
+  std::string buffer_;    // Text not yet parsed.
+  size_t object_start_;   // Where the object starts in buffer_.
+  size_t scanned_;        // How much of buffer_ has been scanned.
+  // Scanner state, kept between chunks:
+  int depth_;             // Nesting of {} and [].
+  char quote_;            // Quote of the string we're in, or 0.
+  bool escape_;           // In a string, after a backslash.
+  CommentState comment_;
+  bool done_;
+};
+
 // Utility functions for multiple generators:
 
 extern std::string MakeCamel(const std::string &in, bool first = true);
@@ -590,17 +788,26 @@ extern void GenComment(const std::vector<std::string> &dc,
                        const CommentConfig *config,
                        const char *prefix = "");
 
+class TextSink;
+
 // Generate text (JSON) from a given FlatBuffer, and a given Parser
 // object that has been populated with the corresponding schema.
 // If ident_step is 0, no indentation will be generated. Additionally,
 // if it is less than 0, no linefeeds will be generated either.
 // See idl_gen_text.cpp.
 // strict_json adds "quotes" around field names if true.
+// compact_json leaves out all whitespace.
 // If the flatbuffer cannot be encoded in JSON (e.g., it contains non-UTF-8
 // byte arrays in String values), returns false.
 extern bool GenerateText(const Parser &parser,
                          const void *flatbuffer,
                          std::string *text);
+// Same, but appends the text to a sink, e.g. a BufferedTextSink to write it
+// out without holding all of it in memory. Errors writing the text are
+// reported by the sink's Flush().
+extern bool GenerateText(const Parser &parser,
+                         const void *flatbuffer,
+                         TextSink *sink);
 extern bool GenerateTextFile(const Parser &parser,
                              const std::string &path,
                              const std::string &file_name);
@@ -0,0 +1,898 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_JSON_H_
+#define FLATBUFFERS_JSON_H_
+
+#include <string>
+#include <vector>
+
+#include "flatbuffers/util.h"
+
+// The runtime of JSON support: writing text to sinks, escaping strings, and
+// the lexing rules the Parser shares with the JsonScanner used by the
+// ToJson()/ParseJson() methods flatc --gen-json generates.
+
+namespace flatbuffers {
+
+// Destination for generated text, see GenerateText() in idl.h.
+// Text is appended into a buffer, and subclasses decide what happens when it
+// fills up: StringTextSink grows it, BufferedTextSink writes it out and
+// starts over, such that output of any size needs a fixed amount of memory.
+// Call Flush() (or destroy the sink) when done.
+class TextSink {
+ public:
+  TextSink() : cur_(nullptr), end_(nullptr), error_(false) {}
+  virtual ~TextSink() {}
+
+  void Append(const char *s, size_t len) {
+    if (static_cast<size_t>(end_ - cur_) >= len) {
+      memcpy(cur_, s, len);
+      cur_ += len;
+    } else {
+      AppendSlow(s, len);
+    }
+  }
+  // Append count copies of c, e.g. for indentation.
+  void Fill(size_t count, char c) {
+    while (count) {
+      if (cur_ == end_) Grow(1);
+      auto n = std::min(count, static_cast<size_t>(end_ - cur_));
+      memset(cur_, c, n);
+      cur_ += n;
+      count -= n;
+    }
+  }
+  TextSink &operator+=(const char *s) { Append(s, strlen(s)); return *this; }
+  TextSink &operator+=(const std::string &s) {
+    Append(s.c_str(), s.length());
+    return *this;
+  }
+  TextSink &operator+=(char c) {
+    if (cur_ == end_) Grow(1);
+    *cur_++ = c;
+    return *this;
+  }
+
+  // Returns space for up to len (at most kMaxNumToCharsLength) characters
+  // to be written into directly, after which Commit() must be called with
+  // the end of what was written, e.g.:
+  //   sink.Commit(NumToChars(value, sink.Reserve(kMaxNumToCharsLength)));
+  char *Reserve(size_t len) {
+    if (static_cast<size_t>(end_ - cur_) < len) Grow(len);
+    return cur_;
+  }
+  void Commit(char *end) { cur_ = end; }
+
+  // Appends the same characters as NumToString().
+  template<typename T> void AppendNumber(T t) {
+    Commit(NumToChars(t, Reserve(kMaxNumToCharsLength)));
+  }
+
+  // Makes all text appended so far available at its destination.
+  // Returns false if any output so far failed.
+  virtual bool Flush() = 0;
+
+  bool Error() const { return error_; }
+
+ protected:
+  // Make room for at least len characters at cur_.
+  virtual void Grow(size_t len) = 0;
+
+  char *cur_;  // Where the next character goes.
+  char *end_;  // End of the space available at cur_.
+  bool error_;
+
+ private:
+  void AppendSlow(const char *s, size_t len) {
+    for (;;) {
+      auto n = std::min(len, static_cast<size_t>(end_ - cur_));
+      memcpy(cur_, s, n);
+      cur_ += n;
+      s += n;
+      len -= n;
+      if (!len) break;
+      Grow(1);
+    }
+  }
+};
+
+// Appends text to a string. The string is used as the buffer, so its size
+// only matches the text once the sink has been flushed or destroyed.
+class StringTextSink : public TextSink {
+ public:
+  explicit StringTextSink(std::string *text) : text_(text) {
+    auto used = text_->size();
+    text_->resize(used + 1024);  // Reduce amount of inevitable reallocs.
+    Reset(used);
+  }
+  ~StringTextSink() { Flush(); }
+
+  bool Flush() {
+    text_->resize(static_cast<size_t>(cur_ - &(*text_)[0]));
+    Reset(text_->size());
+    return true;
+  }
+
+ protected:
+  void Grow(size_t len) {
+    auto used = static_cast<size_t>(cur_ - &(*text_)[0]);
+    text_->resize(std::max(text_->size() * 2, used + len));
+    Reset(used);
+  }
+
+ private:
+  void Reset(size_t used) {
+    cur_ = &(*text_)[0] + used;
+    end_ = &(*text_)[0] + text_->size();
+  }
+
+  std::string *text_;
+};
+
+// Collects text in a fixed size buffer, and hands it to an output function
+// whenever it is full. The fd and FILE* destinations are not closed by this
+// class.
+class BufferedTextSink : public TextSink {
+ public:
+  // Receives each chunk of text, along with the context passed to the
+  // constructor. Returns false if the text could not be written.
+  typedef bool (*OutputCallback)(void *context, const char *text, size_t len);
+
+  BufferedTextSink(OutputCallback output, void *context,
+                   size_t buffer_size = 1 << 16);
+  explicit BufferedTextSink(int fd, size_t buffer_size = 1 << 16);
+  explicit BufferedTextSink(FILE *file, size_t buffer_size = 1 << 16);
+  #ifndef FLATBUFFERS_CPP98_STL
+  typedef std::function<bool(const char *text, size_t len)> OutputFunction;
+
+  explicit BufferedTextSink(const OutputFunction &output,
+                            size_t buffer_size = 1 << 16)
+    : BufferedTextSink(CallFunction, new OutputFunction(output),
+                       buffer_size) {
+    release_ = DeleteFunction;
+  }
+  #endif  // FLATBUFFERS_CPP98_STL
+  ~BufferedTextSink() {
+    Flush();
+    if (release_) release_(context_);
+  }
+
+  bool Flush();
+
+ protected:
+  void Grow(size_t len);
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  BufferedTextSink(const BufferedTextSink &);
+  BufferedTextSink &operator=(const BufferedTextSink &);
+
+  #ifndef FLATBUFFERS_CPP98_STL
+  static bool CallFunction(void *function, const char *text, size_t len) {
+    return (*static_cast<OutputFunction *>(function))(text, len);
+  }
+  static void DeleteFunction(void *function) {
+    delete static_cast<OutputFunction *>(function);
+  }
+  #endif  // FLATBUFFERS_CPP98_STL
+
+  OutputCallback output_;
+  void *context_;
+  void (*release_)(void *context);  // Frees context_, if set.
+  std::vector<char> buffer_;
+};
+
+namespace json_internal {
+
+// Returns non-zero if any of the 8 bytes in w has to be escaped in JSON, i.e.
+// is a control character, '"', '\\', DEL or not ASCII. Borrows may flag bytes
+// after the first one that needs escaping, but never before it.
+inline uint64_t NeedsJsonEscape(uint64_t w) {
+  const uint64_t kOnes = 0x0101010101010101ULL;
+  const uint64_t kHighBits = kOnes * 0x80;
+  auto quote = w ^ (kOnes * '"');
+  auto backslash = w ^ (kOnes * '\\');
+  return ((w - kOnes * ' ') | (quote - kOnes) | (backslash - kOnes) |
+          (w + kOnes)) & kHighBits;  // The last one catches DEL and above.
+}
+
+inline bool NeedsJsonEscape(char c) {
+  return c < ' ' || c > '~' || c == '"' || c == '\\';
+}
+
+// Appends "\u" followed by 4 hex digits.
+inline void EscapeUnicode(uint32_t ucc, TextSink *text) {
+  static const char kHexDigits[] = "0123456789ABCDEF";
+  auto p = text->Reserve(6);
+  p[0] = '\\';
+  p[1] = 'u';
+  for (int i = 5; i >= 2; i--, ucc >>= 4) p[i] = kHexDigits[ucc & 15];
+  text->Commit(p + 6);
+}
+
+}  // namespace json_internal
+
+// Appends s as a quoted JSON string, with everything but printable ASCII
+// escaped. Invalid UTF-8 is written as \x escapes if allow_non_utf8 is set,
+// otherwise it makes this return false.
+inline bool EscapeJsonString(const char *s, size_t len, bool allow_non_utf8,
+                             TextSink *_text) {
+  TextSink &text = *_text;
+  text += "\"";
+  auto cur = s;
+  auto end = s + len;
+  for (;;) {
+    // Copy the longest run of characters that don't need escaping in one go,
+    // checking 8 at a time while we can.
+    auto run = cur;
+    for (; end - cur >= 8; cur += 8) {
+      uint64_t w;
+      memcpy(&w, cur, sizeof(w));
+      if (json_internal::NeedsJsonEscape(w)) break;
+    }
+    while (cur != end && !json_internal::NeedsJsonEscape(*cur)) cur++;
+    text.Append(run, static_cast<size_t>(cur - run));
+    if (cur == end) break;
+    switch (*cur) {
+      case '\n': text += "\\n"; break;
+      case '\t': text += "\\t"; break;
+      case '\r': text += "\\r"; break;
+      case '\b': text += "\\b"; break;
+      case '\f': text += "\\f"; break;
+      case '\"': text += "\\\""; break;
+      case '\\': text += "\\\\"; break;
+      default: {
+        // Not printable ASCII data. Let's see if it's valid UTF-8 first:
+        auto utf8 = cur;
+        int ucc = FromUTF8(&utf8);
+        if (ucc < 0) {
+          if (allow_non_utf8) {
+            text += "\\x";
+            text += IntToStringHex(static_cast<uint8_t>(*cur), 2);
+            break;
+          } else {
+            // There are two cases here:
+            //
+            // 1) We reached here by parsing an IDL file. In that case,
+            // we previously checked for non-UTF-8, so we shouldn't reach
+            // here.
+            //
+            // 2) We reached here by someone calling GenerateText()
+            // on a previously-serialized flatbuffer. The data might have
+            // non-UTF-8 Strings, or might be corrupt.
+            //
+            // In both cases, we have to give up and inform the caller
+            // they have no JSON.
+            return false;
+          }
+        }
+        if (ucc <= 0xFFFF) {
+          // Parses as Unicode within JSON's \uXXXX range, so use that.
+          json_internal::EscapeUnicode(static_cast<uint32_t>(ucc), _text);
+        } else if (ucc <= 0x10FFFF) {
+          // Encode Unicode SMP values to a surrogate pair using two \u escapes.
+          uint32_t base = ucc - 0x10000;
+          json_internal::EscapeUnicode((base >> 10) + 0xD800, _text);
+          json_internal::EscapeUnicode((base & 0x03FF) + 0xDC00, _text);
+        }
+        // Skip past characters recognized.
+        cur = utf8;
+        continue;
+      }
+    }
+    cur++;
+  }
+  text += "\"";
+  return true;
+}
+
+// Lexing rules shared by Parser::Next() and JsonScanner, such that both
+// accept the same text. They're kept out of the flatbuffers namespace, since
+// every header generated with --gen-json includes this one.
+namespace json_internal {
+
+inline bool IsIdentifierStart(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool IsIdentifierChar(char c) {
+  return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+inline bool IsHexDigit(char c) {
+  return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+// Whether s holds nothing but complete UTF-8 sequences.
+inline bool ValidateUTF8(const char *s, size_t len) {
+  for (auto end = s + len; s < end; ) {
+    if (FromUTF8(&s) < 0) return false;
+  }
+  return true;
+}
+
+// Finds the end of a run of characters in a string constant that need no
+// special handling: anything but the quote character, backslashes and
+// control characters. Tests 8 bytes at a time where the source is long
+// enough, using the "has less than" bit trick. Sets *non_ascii if the run
+// contains bytes with the high bit set (i.e. UTF-8 sequences).
+inline const char *ScanStringChars(const char *s, const char *end, char quote,
+                                   bool *non_ascii) {
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t highs = 0x8080808080808080ULL;
+  const uint64_t quotes = ones * static_cast<unsigned char>(quote);
+  const uint64_t backslashes = ones * '\\';
+  while (end - s >= 8) {
+    uint64_t w;
+    memcpy(&w, s, sizeof(w));
+    // A byte is 0 in these if it matches the quote or backslash.
+    auto q = w ^ quotes, b = w ^ backslashes;
+    auto special = ((w - ones * ' ') & ~w) |
+                   ((q - ones) & ~q) |
+                   ((b - ones) & ~b);
+    if (special & highs) break;
+    if (w & highs) *non_ascii = true;
+    s += 8;
+  }
+  for (; s < end; s++) {
+    auto c = *s;
+    if (c == quote || c == '\\' || (c < ' ' && c >= 0)) break;
+    if (static_cast<unsigned char>(c) >= 0x80) *non_ascii = true;
+  }
+  return s;
+}
+
+// Reads exactly nibbles hex digits at *s into *val.
+inline bool ScanHex(const char **s, const char *end, int nibbles,
+                    uint32_t *val) {
+  *val = 0;
+  for (int i = 0; i < nibbles; i++, (*s)++) {
+    if (*s == end || !IsHexDigit(**s)) return false;
+    auto c = **s;
+    *val = *val * 16 + static_cast<uint32_t>(
+        c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+  }
+  return true;
+}
+
+// Unescapes the string constant at s, which follows its opening quote, and
+// appends it to *out. Sets *non_ascii if that contains bytes with the high
+// bit set. Returns the position after the closing quote, or nullptr with the
+// reason in *error.
+inline const char *ScanStringConstant(const char *s, const char *end,
+                                      char quote, std::string *out,
+                                      bool *non_ascii, const char **error) {
+  int high_surrogate = -1;
+  for (;;) {
+    // Copy plain characters a whole run at a time.
+    auto run_end = ScanStringChars(s, end, quote, non_ascii);
+    if (run_end != s) {
+      if (high_surrogate != -1) break;
+      out->append(s, run_end);
+      s = run_end;
+    }
+    if (s == end || (*s < ' ' && *s >= 0)) {
+      *error = "illegal character in string constant";
+      return nullptr;
+    }
+    if (*s == quote) {
+      if (high_surrogate != -1) break;
+      return s + 1;
+    }
+    // A backslash.
+    if (++s == end) continue;  // Reported above.
+    auto c = *s++;
+    if (high_surrogate != -1 && c != 'u') break;
+    uint32_t val;
+    switch (c) {
+      case 'n':  *out += '\n'; break;
+      case 't':  *out += '\t'; break;
+      case 'r':  *out += '\r'; break;
+      case 'b':  *out += '\b'; break;
+      case 'f':  *out += '\f'; break;
+      case '\"': *out += '\"'; break;
+      case '\'': *out += '\''; break;
+      case '\\': *out += '\\'; break;
+      case '/':  *out += '/';  break;
+      case 'x':  // Not in the JSON standard.
+        if (!ScanHex(&s, end, 2, &val)) {
+          *error = "escape code must be followed by 2 hex digits";
+          return nullptr;
+        }
+        *out += static_cast<char>(val);
+        if (val >= 0x80) *non_ascii = true;
+        break;
+      case 'u':
+        if (!ScanHex(&s, end, 4, &val)) {
+          *error = "escape code must be followed by 4 hex digits";
+          return nullptr;
+        }
+        if (val >= 0xD800 && val <= 0xDBFF) {
+          if (high_surrogate != -1) {
+            *error = "illegal Unicode sequence (multiple high surrogates)";
+            return nullptr;
+          }
+          high_surrogate = static_cast<int>(val);
+        } else if (val >= 0xDC00 && val <= 0xDFFF) {
+          if (high_surrogate == -1) {
+            *error = "illegal Unicode sequence (unpaired low surrogate)";
+            return nullptr;
+          }
+          ToUTF8(0x10000 + ((static_cast<uint32_t>(high_surrogate) & 0x03FF)
+                            << 10) + (val & 0x03FF), out);
+          high_surrogate = -1;
+        } else if (high_surrogate != -1) {
+          *error = "illegal Unicode sequence (unpaired high surrogate)";
+          return nullptr;
+        } else {
+          ToUTF8(val, out);
+        }
+        break;
+      default:
+        *error = "unknown escape code in string constant";
+        return nullptr;
+    }
+  }
+  *error = "illegal Unicode sequence (unpaired high surrogate)";
+  return nullptr;
+}
+
+// Scans the number constant at s, which starts with a digit or '-', into
+// *out. Hexadecimal numbers are converted to decimal, so the text can be
+// read with StringToInt(). Returns where the number ends.
+inline const char *ScanNumberConstant(const char *s, const char *end,
+                                      std::string *out, bool *is_float) {
+  out->clear();
+  *is_float = false;
+  auto start = s;
+  auto peek = [&](size_t i) {
+    return static_cast<size_t>(end - s) > i ? s[i] : '\0';
+  };
+  auto digits = [&]() { while (peek(0) >= '0' && peek(0) <= '9') s++; };
+  if (*s == '-' && peek(1) == '0' && (peek(2) == 'x' || peek(2) == 'X')) {
+    *out += '-';
+    s++;
+  }
+  if (*s == '0' && (peek(1) == 'x' || peek(1) == 'X')) {
+    s += 2;
+    auto hex = s;
+    while (s != end && IsHexDigit(*s)) s++;
+    out->append(hex, s);
+    *out = NumToString(StringToUInt(out->c_str(), nullptr, 16));
+    return s;
+  }
+  s++;
+  digits();
+  if (peek(0) == '.' || peek(0) == 'e' || peek(0) == 'E') {
+    if (peek(0) == '.') {
+      s++;
+      digits();
+    }
+    // See if this float has a scientific notation suffix. Both JSON
+    // and C++ (through strtod() we use) have the same format:
+    if (peek(0) == 'e' || peek(0) == 'E') {
+      s++;
+      if (peek(0) == '+' || peek(0) == '-') s++;
+      digits();
+    }
+    *is_float = true;
+  }
+  out->assign(start, s);
+  return s;
+}
+
+// The text of an "illegal character: " error for c.
+inline std::string IllegalCharacter(char c) {
+  return c < ' ' || c > '~'
+    ? "code: " + NumToString(static_cast<int>(static_cast<unsigned char>(c)))
+    : std::string(1, c);
+}
+
+}  // namespace json_internal
+
+// Reads JSON a token at a time, for the ParseJson() methods generated by
+// flatc --gen-json: those know the schema at compile time, so they need no
+// Parser. Tokens follow the same rules as the Parser's (see above): unquoted
+// field names, single quoted strings, \x escapes, hexadecimal numbers and
+// comments are accepted, what is allowed where is up to the caller.
+class JsonScanner {
+ public:
+  // Single character tokens are represented by their character (e.g. '{').
+  enum {
+    kTokenEof = 256,
+    kTokenStringConstant,
+    kTokenIntegerConstant,
+    kTokenFloatConstant,
+    kTokenIdentifier,
+    kTokenNull
+  };
+
+  // Looks up an enum value by name, e.g. the generated EnumValueColor().
+  typedef bool (*EnumLookup)(const char *name, size_t length, int64_t *value);
+
+  // Where the scanner is, to continue from there with Restore(). Only the
+  // kind of the current token is kept, not its text.
+  struct State {
+    const char *cursor;
+    int line;
+    int token;
+    bool replaying;
+    size_t replay_pos;
+  };
+
+  // Call Next() to read the first token.
+  JsonScanner(const char *json, size_t length)
+    : cursor_(json), end_(json + length), line_(1), token_(kTokenEof),
+      token_start_(json), text_(nullptr), length_(0), non_ascii_(false),
+      replaying_(false), replay_pos_(0) {
+    if (length >= 3 && !memcmp(json, "\xEF\xBB\xBF", 3)) cursor_ += 3;
+  }
+
+  int token() const { return token_; }
+  // The text of identifiers, strings (unescaped) and numbers.
+  const char *text() const { return text_; }
+  size_t length() const { return length_; }
+  // Set by the first call that returned false.
+  const std::string &error() const { return error_; }
+
+  bool Is(int t) const { return token_ == t; }
+
+  // Reads the next token.
+  bool Next() {
+    if (replaying_) {
+      if (replay_pos_ >= recorded_.size())
+        return Error("unexpected end of recorded value");
+      auto &recorded = recorded_[replay_pos_++];
+      token_ = recorded.token;
+      line_ = recorded.line;
+      text_ = recorded.text.c_str();
+      length_ = recorded.text.size();
+      non_ascii_ = recorded.non_ascii;
+      return true;
+    }
+    for (;;) {
+      if (cursor_ == end_) {
+        token_start_ = cursor_;
+        token_ = kTokenEof;
+        return true;
+      }
+      auto c = *cursor_;
+      if (c == '/' && Peek(1) == '/') {
+        while (cursor_ != end_ && *cursor_ != '\n') cursor_++;
+        continue;
+      }
+      if (c == '/' && Peek(1) == '*') {
+        for (cursor_ += 2; Peek(0) != '*' || Peek(1) != '/'; cursor_++) {
+          if (cursor_ == end_) return Error("end of file in comment");
+          if (*cursor_ == '\n') line_++;
+        }
+        cursor_ += 2;
+        continue;
+      }
+      if (c == '\n') {
+        line_++;
+      } else if (c != ' ' && c != '\r' && c != '\t') {
+        break;
+      }
+      cursor_++;
+    }
+    token_start_ = cursor_;
+    auto c = *cursor_++;
+    switch (c) {
+      case '{': case '}': case '(': case ')': case '[': case ']':
+      case ',': case ':': case ';': case '=':
+        token_ = c;
+        return true;
+      case '.':
+        if (Peek(0) >= '0' && Peek(0) <= '9')
+          return Error("floating point constant can\'t start with \".\"");
+        token_ = c;
+        return true;
+      case '\"':
+      case '\'':
+        return ScanString(c);
+      case '\0':
+        return Error("illegal 0 byte in source, is it a binary file?");
+      default:
+        break;
+    }
+    if (json_internal::IsIdentifierStart(c)) {
+      while (json_internal::IsIdentifierChar(Peek(0))) cursor_++;
+      text_ = token_start_;
+      length_ = static_cast<size_t>(cursor_ - token_start_);
+      // Booleans are integers, as in the Parser.
+      if (IsWord("true") || IsWord("false")) {
+        text_ = IsWord("true") ? "1" : "0";
+        length_ = 1;
+        token_ = kTokenIntegerConstant;
+      } else {
+        token_ = IsWord("null") ? kTokenNull : kTokenIdentifier;
+      }
+      return true;
+    }
+    if ((c >= '0' && c <= '9') || c == '-') {
+      bool is_float;
+      cursor_ = json_internal::ScanNumberConstant(token_start_, end_,
+                                                  &number_, &is_float);
+      token_ = is_float ? kTokenFloatConstant : kTokenIntegerConstant;
+      text_ = number_.c_str();
+      length_ = number_.size();
+      return true;
+    }
+    return Error("illegal character: " +
+                 json_internal::IllegalCharacter(c));
+  }
+
+  // Reads the current token, which has to be t, and the next one.
+  bool Expect(int t) {
+    if (token_ != t) {
+      return Error("expecting: " + TokenToString(t) + " instead got: " +
+                   TokenToString(token_));
+    }
+    return Next();
+  }
+
+  // Reads a field name: a string, or if not strict, also an identifier. The
+  // name is only valid until the next token is read.
+  bool ParseFieldName(bool strict, const char **name, size_t *length) {
+    if (!Is(kTokenStringConstant) && (strict || !Is(kTokenIdentifier)))
+      return Expect(strict ? kTokenStringConstant : kTokenIdentifier);
+    *name = text_;
+    *length = length_;
+    return Next();
+  }
+
+  // Reads a string value into fbb.
+  bool ParseString(bool allow_non_utf8, FlatBufferBuilder &fbb,
+                   Offset<String> *str) {
+    if (!Is(kTokenStringConstant)) return Expect(kTokenStringConstant);
+    if (non_ascii_ && !allow_non_utf8 &&
+        !json_internal::ValidateUTF8(text_, length_))
+      return Error("illegal UTF-8 sequence");
+    *str = fbb.CreateString(text_, length_);
+    return Next();
+  }
+
+  // Reads an integer or bool: a number, true or false, a number in a string,
+  // or enum identifiers looked up with lookup (several in a string,
+  // separated by spaces, are or-ed together). It has to fit in bits, either
+  // as a signed or an unsigned value.
+  bool ParseInteger(EnumLookup lookup, size_t bits, int64_t *val) {
+    if (Is(kTokenIntegerConstant)) {
+      *val = StringToInt(text_);
+    } else if ((Is(kTokenIdentifier) || Is(kTokenStringConstant)) &&
+               length_ && json_internal::IsIdentifierStart(*text_)) {
+      if (!lookup)
+        return Error("enum values need to be qualified by an enum type");
+      *val = 0;
+      auto word = text_, end = text_ + length_;
+      while (word != end) {
+        auto word_end = word;
+        while (word_end != end && *word_end != ' ') word_end++;
+        int64_t v;
+        if (!lookup(word, static_cast<size_t>(word_end - word), &v))
+          return Error("unknown enum value: " + std::string(word, word_end));
+        *val |= v;
+        for (word = word_end; word != end && *word == ' '; word++) {}
+      }
+    } else if (Is(kTokenStringConstant)) {
+      std::string s(text_, length_);
+      char *end;
+      *val = StringToInt(s.c_str(), &end);
+      if (*end) return Error("invalid integer: " + s);
+    } else {
+      return Error("cannot parse value starting with: " +
+                   TokenToString(token_));
+    }
+    if (bits < 64) {
+      auto mask = static_cast<int64_t>((1ULL << bits) - 1);
+      if ((*val & ~mask) != 0 && (*val | mask) != -1)
+        return Error("constant does not fit in a " + NumToString(bits) +
+                     "-bit field");
+    }
+    return Next();
+  }
+
+  // Like ParseInteger(), but identifiers and strings are hashed with hash
+  // (see hash.h).
+  template<typename T> bool ParseHash(T (*hash)(const char *), size_t bits,
+                                      int64_t *val) {
+    if (!Is(kTokenIdentifier) && !Is(kTokenStringConstant))
+      return ParseInteger(nullptr, bits, val);
+    *val = static_cast<int64_t>(hash(std::string(text_, length_).c_str()));
+    return Next();
+  }
+
+  // Reads a float or double: a number, or a number in a string.
+  bool ParseFloat(double *val) {
+    if (Is(kTokenIntegerConstant) || Is(kTokenFloatConstant)) {
+      *val = StringToDouble(text_);
+    } else if (Is(kTokenStringConstant) &&
+               !(length_ && json_internal::IsIdentifierStart(*text_))) {
+      std::string s(text_, length_);
+      char *end;
+      *val = StringToDouble(s.c_str(), &end);
+      if (*end) return Error("invalid float: " + s);
+    } else if (Is(kTokenIdentifier) || Is(kTokenStringConstant)) {
+      return Error("not a valid value for this field: " +
+                   std::string(text_, length_));
+    } else {
+      return Error("cannot parse value starting with: " +
+                   TokenToString(token_));
+    }
+    return Next();
+  }
+
+  // Reads past the value starting at the current token. Only brackets are
+  // matched, syntax errors inside are not found.
+  bool SkipValue() {
+    int depth = 0;
+    do {
+      if (Is('{') || Is('[')) {
+        depth++;
+      } else if (Is('}') || Is(']') || Is(',') || Is(':') ||
+                 Is(kTokenEof)) {
+        if (!depth || Is(kTokenEof)) {
+          return Error("unexpected token: " + TokenToString(token_));
+        }
+        if (Is('}') || Is(']')) depth--;
+      }
+      if (!Next()) return false;
+    } while (depth);
+    return true;
+  }
+
+  // Like SkipValue(), but keeps the tokens of the value (and the one after
+  // it), such that Replay() can read them again without scanning the source
+  // again. *value is where the value starts in the recording. Values that
+  // were recorded already are not copied again: skipping them while
+  // replaying is a jump.
+  bool RecordValue(size_t *value) {
+    if (replaying_) {
+      *value = replay_pos_ - 1;
+      replay_pos_ = recorded_[*value].end;
+      return Next();
+    }
+    recorded_.clear();
+    *value = 0;
+    std::vector<size_t> open;
+    do {
+      if (Is('}') || Is(']') || Is(',') || Is(':') || Is(kTokenEof)) {
+        if (open.empty() || Is(kTokenEof)) {
+          return Error("unexpected token: " + TokenToString(token_));
+        }
+      }
+      auto index = recorded_.size();
+      Record(index + 1);
+      if (Is('{') || Is('[')) {
+        open.push_back(index);
+      } else if (Is('}') || Is(']')) {
+        recorded_[open.back()].end = index + 1;
+        open.pop_back();
+      }
+      if (!Next()) return false;
+    } while (!open.empty());
+    Record(recorded_.size() + 1);
+    return true;
+  }
+
+  // Reads the value that starts at value in the recording, until Restore().
+  bool Replay(size_t value) {
+    replaying_ = true;
+    replay_pos_ = value;
+    return Next();
+  }
+
+  State Save() const {
+    State state = { cursor_, line_, token_, replaying_, replay_pos_ };
+    return state;
+  }
+
+  void Restore(const State &state) {
+    cursor_ = state.cursor;
+    line_ = state.line;
+    token_ = state.token;
+    text_ = nullptr;
+    length_ = 0;
+    replaying_ = state.replaying;
+    replay_pos_ = state.replay_pos;
+  }
+
+  // Sets the error, in the same format as Parser::error_. Returns false.
+  bool Error(const std::string &msg) {
+    error_ = NumToString(line_) + ":0: error: " + msg;
+    return false;
+  }
+
+ private:
+  struct RecordedToken {
+    int token;
+    int line;
+    std::string text;
+    bool non_ascii;
+    size_t end;  // Where the recording continues after this value.
+  };
+
+  void Record(size_t end) {
+    auto has_text = token_ > kTokenEof && token_ < kTokenNull;
+    RecordedToken recorded = {
+      token_, line_, has_text ? std::string(text_, length_) : std::string(),
+      non_ascii_, end
+    };
+    recorded_.push_back(recorded);
+  }
+
+  static std::string TokenToString(int t) {
+    static const char *tokens[] = {
+      "end of file", "string constant", "integer constant", "float constant",
+      "identifier", "null"
+    };
+    return t < kTokenEof ? std::string(1, static_cast<char>(t))
+                         : tokens[t - kTokenEof];
+  }
+
+  char Peek(size_t i) const {
+    return static_cast<size_t>(end_ - cursor_) > i ? cursor_[i] : '\0';
+  }
+
+  bool IsWord(const char *word) const {
+    return length_ == strlen(word) && !memcmp(text_, word, length_);
+  }
+
+  // Strings without escapes are returned in place, others are unescaped
+  // into string_.
+  bool ScanString(char quote) {
+    auto start = cursor_;
+    non_ascii_ = false;
+    cursor_ = json_internal::ScanStringChars(cursor_, end_, quote,
+                                             &non_ascii_);
+    token_ = kTokenStringConstant;
+    if (Peek(0) == quote) {
+      text_ = start;
+      length_ = static_cast<size_t>(cursor_++ - start);
+      return true;
+    }
+    string_.assign(start, cursor_);
+    const char *error;
+    auto string_end = json_internal::ScanStringConstant(
+        cursor_, end_, quote, &string_, &non_ascii_, &error);
+    if (!string_end) return Error(error);
+    cursor_ = string_end;
+    text_ = string_.c_str();
+    length_ = string_.size();
+    return true;
+  }
+
+  const char *cursor_;
+  const char *end_;
+  int line_;
+  int token_;
+  const char *token_start_;
+  const char *text_;
+  size_t length_;
+  bool non_ascii_;
+  std::vector<RecordedToken> recorded_;
+  bool replaying_;
+  size_t replay_pos_;
+  std::string number_;
+  std::string string_;
+  std::string error_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_JSON_H_
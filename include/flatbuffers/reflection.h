@@ -394,6 +394,68 @@ void ResizeVector(const reflection::Schema &schema, uoffset_t newsize, T val,
 }
 #endif
 
+// Each SetString() / ResizeAnyVector() call above walks all offsets in the
+// buffer and moves everything after the resized item. To change many strings
+// and vectors, record them in a ResizeTransaction instead, which does both
+// once for all of them in Commit().
+// The strings and vectors passed in must live inside "flatbuf", and may each
+// only be changed once per transaction. The buffer isn't touched until
+// Commit(), so they (and other pointers into it) stay valid until then.
+// Unlike ResizeAnyVector(), shrinking a vector removes its last elements
+// from the buffer, rather than the bytes that follow it.
+class ResizeTransaction {
+ public:
+  ResizeTransaction(const reflection::Schema &schema,
+                    std::vector<uint8_t> *flatbuf,
+                    const reflection::Object *root_table = nullptr)
+    : schema_(schema), buf_(*flatbuf), root_table_(root_table) {}
+
+  void SetString(const std::string &val, const String *str);
+
+  // New elements are set to the elem_size bytes at "val", or 0 if null.
+  void ResizeAnyVector(uoffset_t newsize, const VectorOfAny *vec,
+                       uoffset_t num_elems, uoffset_t elem_size,
+                       const uint8_t *val = nullptr);
+
+#ifndef FLATBUFFERS_CPP98_STL
+  template <typename T>
+  void ResizeVector(uoffset_t newsize, T val, const Vector<T> *vec) {
+    uint8_t elem[sizeof(T)];
+    if (std::is_scalar<T>::value) {
+      WriteScalar(elem, val);
+    } else {  // struct
+      memcpy(elem, &val, sizeof(T));
+    }
+    ResizeAnyVector(newsize, reinterpret_cast<const VectorOfAny *>(vec),
+                    vec->size(), static_cast<uoffset_t>(sizeof(T)), elem);
+  }
+#endif
+
+  // Applies all changes recorded so far, and starts a new transaction.
+  void Commit();
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  ResizeTransaction(const ResizeTransaction &);
+  ResizeTransaction &operator=(const ResizeTransaction &);
+
+  struct Resize {
+    uoffset_t start;      // Where bytes get inserted or removed.
+    int delta;            // How many, a multiple of sizeof(largest_scalar_t).
+    uoffset_t object;     // The length field of the string or vector.
+    uoffset_t old_size;   // Its current number of elements.
+    uoffset_t new_size;
+    uoffset_t elem_size;  // 0 for strings.
+    std::string data;     // The new string, or the value of new elements.
+    bool operator<(const Resize &other) const { return start < other.start; }
+  };
+
+  const reflection::Schema &schema_;
+  std::vector<uint8_t> &buf_;
+  const reflection::Object *root_table_;
+  std::vector<Resize> resizes_;
+};
+
 // Adds any new data (in the form of a new FlatBuffer) to an existing
 // FlatBuffer. This can be used when any of the above methods are not
 // sufficient, in particular for adding new tables and new fields.
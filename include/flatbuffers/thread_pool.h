@@ -0,0 +1,112 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_THREAD_POOL_H_
+#define FLATBUFFERS_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace flatbuffers {
+
+// A minimal pool of worker threads, to run work in parallel.
+// Threads that wait for their tasks to finish pick up queued tasks in the
+// meantime, so tasks can themselves run tasks in parallel without deadlock.
+class ThreadPool {
+ public:
+  // num_threads is the number of worker threads, on top of the threads that
+  // call ParallelFor().
+  explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency())
+    : stop_(false) {
+    for (size_t i = 0; i < num_threads; i++) {
+      threads_.push_back(std::thread([this]() { Work(); }));
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto it = threads_.begin(); it != threads_.end(); ++it) it->join();
+  }
+
+  // Runs task(0) .. task(count - 1) in parallel, and returns when they are
+  // all done. Matches Verifier::ParallelFor, e.g.:
+  //   verifier.SetParallelFor([&](size_t n,
+  //                               const std::function<void(size_t)> &task) {
+  //     pool.ParallelFor(n, task);
+  //   });
+  void ParallelFor(size_t count, const std::function<void(size_t)> &task) {
+    size_t remaining = count;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; i++) {
+      tasks_.push_back([&, i]() {
+        task(i);
+        std::lock_guard<std::mutex> done_lock(mutex_);
+        if (!--remaining) cv_.notify_all();
+      });
+    }
+    cv_.notify_all();
+    while (remaining) {
+      if (tasks_.empty()) {
+        cv_.wait(lock);
+      } else {
+        RunOne(lock);
+      }
+    }
+  }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  ThreadPool(const ThreadPool &);
+  ThreadPool &operator=(const ThreadPool &);
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (stop_) return;
+      RunOne(lock);
+    }
+  }
+
+  // Runs the first queued task, without holding the lock.
+  void RunOne(std::unique_lock<std::mutex> &lock) {
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_THREAD_POOL_H_
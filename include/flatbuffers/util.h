@@ -21,8 +21,12 @@
 #include <iomanip>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <float.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
@@ -44,58 +48,334 @@
 
 namespace flatbuffers {
 
-// Convert an integer or floating point value to a string.
-// In contrast to std::stringstream, "char" values are
-// converted to a string of digits, and we don't use scientific notation.
-template<typename T> std::string NumToString(T t) {
+namespace util_internal {
+
+// Writes the decimal digits of u to buf, returns the end of them.
+inline char *UIntToChars(uint64_t u, char *buf) {
+  static const char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233"
+    "34353637383940414243444546474849505152535455565758596061626364656667"
+    "6869707172737475767778798081828384858687888990919293949596979899";
+  char tmp[20];
+  auto p = tmp + sizeof(tmp);
+  while (u >= 100) {
+    auto pair = kDigitPairs + (u % 100) * 2;
+    u /= 100;
+    *--p = pair[1];
+    *--p = pair[0];
+  }
+  if (u >= 10) {
+    *--p = kDigitPairs[u * 2 + 1];
+    *--p = kDigitPairs[u * 2];
+  } else {
+    *--p = static_cast<char>('0' + u);
+  }
+  auto len = static_cast<size_t>(tmp + sizeof(tmp) - p);
+  memcpy(buf, p, len);
+  return buf + len;
+}
+
+inline char *IntToChars(int64_t i, char *buf) {
+  if (i >= 0) return UIntToChars(static_cast<uint64_t>(i), buf);
+  *buf++ = '-';
+  return UIntToChars(0 - static_cast<uint64_t>(i), buf);
+}
+
+// The shortest digits that read back as a given float or double are found
+// with the Grisu2 algorithm ("Printing Floating-Point Numbers Quickly and
+// Accurately with Integers", Florian Loitsch), which needs no allocations or
+// big integers.
+
+// A floating point value f * 2^e with a 64 bit significand.
+struct DiyFp {
+  DiyFp(uint64_t _f, int _e) : f(_f), e(_e) {}
+
+  // Multiplies the significands, keeping the (rounded) upper 64 bits.
+  DiyFp operator*(const DiyFp &o) const {
+    const uint64_t kLow = 0xFFFFFFFF;
+    auto a = f >> 32, b = f & kLow, c = o.f >> 32, d = o.f & kLow;
+    auto bc = b * c, ad = a * d;
+    auto mid = ((b * d) >> 32) + (ad & kLow) + (bc & kLow) + (1U << 31);
+    return DiyFp(a * c + (ad >> 32) + (bc >> 32) + (mid >> 32),
+                 e + o.e + 64);
+  }
+
+  DiyFp Normalize() const {
+    auto r = *this;
+    while (!(r.f >> 63)) {
+      r.f <<= 1;
+      r.e--;
+    }
+    return r;
+  }
+
+  uint64_t f;
+  int e;
+};
+
+// Returns 10^-k, picking k such that multiplying a normalized DiyFp with
+// exponent e by it gives an exponent in [-60, -32].
+inline DiyFp CachedPower(int e, int *k) {
+  // 10^-348, 10^-340, .. 10^340, normalized and rounded.
+  static const uint64_t kSignificands[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+  };
+  static const int16_t kExponents[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+  };
+  auto dk = (-61 - e) * 0.30102999566398114 + 347;  // log10(2)
+  auto ik = static_cast<int>(dk);
+  if (dk - ik > 0.0) ik++;
+  auto index = (ik >> 3) + 1;
+  *k = 348 - index * 8;
+  return DiyFp(kSignificands[index], kExponents[index]);
+}
+
+// Steps the last digit down while that brings it closer to w (the value),
+// without leaving the rounding interval.
+inline void GrisuRound(char *digits, int len, uint64_t delta, uint64_t rest,
+                       uint64_t ten_kappa, uint64_t wp_w) {
+  while (rest < wp_w && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < wp_w ||
+          wp_w - rest > rest + ten_kappa - wp_w)) {
+    digits[len - 1]--;
+    rest += ten_kappa;
+  }
+}
+
+// Generates the digits of wp until they are within delta of it.
+inline int DigitGen(const DiyFp &w, const DiyFp &wp, uint64_t delta,
+                    char *digits, int *k) {
+  static const uint32_t kPow10[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+  };
+  DiyFp one(uint64_t(1) << -wp.e, wp.e);
+  auto wp_w = wp.f - w.f;
+  auto p1 = static_cast<uint32_t>(wp.f >> -one.e);  // Integer part.
+  auto p2 = wp.f & (one.f - 1);  // Fraction.
+  int kappa = 1;
+  while (kappa < 9 && p1 >= kPow10[kappa]) kappa++;
+  int len = 0;
+  while (kappa > 0) {
+    auto d = p1 / kPow10[kappa - 1];
+    p1 %= kPow10[kappa - 1];
+    if (d || len) digits[len++] = static_cast<char>('0' + d);
+    kappa--;
+    auto rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      *k += kappa;
+      GrisuRound(digits, len, delta, rest,
+                 static_cast<uint64_t>(kPow10[kappa]) << -one.e, wp_w);
+      return len;
+    }
+  }
+  for (;;) {
+    p2 *= 10;
+    delta *= 10;
+    auto d = static_cast<char>(p2 >> -one.e);
+    if (d || len) digits[len++] = static_cast<char>('0' + d);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *k += kappa;
+      GrisuRound(digits, len, delta, p2, one.f,
+                 -kappa < 9 ? wp_w * kPow10[-kappa] : 0);
+      return len;
+    }
+  }
+}
+
+// Writes the IEEE float or double in bits to buf, in fixed notation with the
+// fewest digits that read back as the same number (Grisu2 is not optimal for
+// a fraction of a percent of numbers, those get one digit more). Returns the
+// end of the characters written.
+inline char *FloatToChars(uint64_t bits, int significand_bits,
+                          int exponent_bits, char *buf) {
+  auto exponent_mask = (1 << exponent_bits) - 1;
+  auto hidden_bit = uint64_t(1) << significand_bits;
+  auto f = bits & (hidden_bit - 1);
+  auto biased_e = static_cast<int>(bits >> significand_bits) & exponent_mask;
+  if (bits >> (significand_bits + exponent_bits)) *buf++ = '-';
+  if (biased_e == exponent_mask) {
+    memcpy(buf, f ? "nan" : "inf", 3);
+    return buf + 3;
+  }
+  if (!biased_e && !f) {
+    *buf++ = '0';
+    return buf;
+  }
+  auto e = (biased_e ? biased_e : 1) - exponent_mask / 2 - significand_bits;
+  if (biased_e) f |= hidden_bit;
+  // Grisu2: scale the value and the boundaries halfway to its neighbours by
+  // a power of ten, then generate digits until they are in between.
+  DiyFp v(f, e);
+  auto plus = DiyFp((f << 1) + 1, e - 1).Normalize();
+  auto minus = f == hidden_bit && biased_e > 1
+                 ? DiyFp((f << 2) - 1, e - 2)  // The lower neighbour is closer.
+                 : DiyFp((f << 1) - 1, e - 1);
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  int k;
+  auto c = CachedPower(plus.e, &k);
+  auto w = v.Normalize() * c;
+  auto wp = plus * c;
+  auto wm = minus * c;
+  wm.f++;
+  wp.f--;
+  char digits[20];
+  auto len = DigitGen(w, wp, wp.f - wm.f, digits, &k);
+  while (len > 1 && digits[len - 1] == '0') {
+    len--;
+    k++;
+  }
+  // The value is digits * 10^k.
+  auto point = len + k;
+  if (k >= 0) {
+    memcpy(buf, digits, len);
+    memset(buf + len, '0', k);
+    return buf + point;
+  } else if (point > 0) {
+    memcpy(buf, digits, point);
+    buf[point] = '.';
+    memcpy(buf + point + 1, digits + point, len - point);
+    return buf + len + 1;
+  } else {
+    memcpy(buf, "0.", 2);
+    memset(buf + 2, '0', -point);
+    memcpy(buf + 2 - point, digits, len);
+    return buf + 2 - point + len;
+  }
+}
+
+}  // namespace util_internal
+
+// The most characters NumToChars() writes: the smallest negative double has
+// 324 digits after the decimal point.
+const int kMaxNumToCharsLength = 330;
+
+// Writes the same characters as NumToString() to buf, which must have room
+// for kMaxNumToCharsLength of them, without allocating. Returns the end of
+// the characters written (no terminating 0 is added).
+template<typename T> char *NumToChars(T t, char *buf) {
+  return std::is_unsigned<T>::value
+           ? util_internal::UIntToChars(static_cast<uint64_t>(t), buf)
+           : util_internal::IntToChars(static_cast<int64_t>(t), buf);
+}
+// Plain char is character data (as when streamed), not a number.
+template<> inline char *NumToChars<char>(char t, char *buf) {
+  *buf = t;
+  return buf + 1;
+}
+template<> inline char *NumToChars<double>(double t, char *buf) {
+  uint64_t bits;
+  memcpy(&bits, &t, sizeof(bits));
+  return util_internal::FloatToChars(bits, 52, 11, buf);
+}
+template<> inline char *NumToChars<float>(float t, char *buf) {
+  uint32_t bits;
+  memcpy(&bits, &t, sizeof(bits));
+  return util_internal::FloatToChars(bits, 23, 8, buf);
+}
+
+namespace util_internal {
+
+template<typename T> std::string NumToString(T t, std::true_type) {
+  char buf[kMaxNumToCharsLength];
+  return std::string(buf, NumToChars(t, buf));
+}
+template<typename T> std::string NumToString(T t, std::false_type) {
   std::stringstream ss;
   ss << t;
   return ss.str();
 }
-// Avoid char types used as character data.
-template<> inline std::string NumToString<signed char>(signed char t) {
-  return NumToString(static_cast<int>(t));
-}
-template<> inline std::string NumToString<unsigned char>(unsigned char t) {
-  return NumToString(static_cast<int>(t));
-}
 
-// Special versions for floats/doubles.
+}  // namespace util_internal
+
+// Convert an integer or floating point value to a string.
+// In contrast to std::stringstream, "signed char" and "unsigned char" values
+// are converted to a string of digits, and we don't use scientific notation.
+// Plain "char" values are streamed as the character, as before.
+// Floats and doubles get the fewest digits that read back as the same value
+// (in rare cases, one more).
+template<typename T> std::string NumToString(T t) {
+  return util_internal::NumToString(t, std::integral_constant<bool,
+      std::is_integral<T>::value || std::is_enum<T>::value>());
+}
 template<> inline std::string NumToString<double>(double t) {
-  // to_string() prints different numbers of digits for floats depending on
-  // platform and isn't available on Android, so we use stringstream
-  std::stringstream ss;
-  // Use std::fixed to surpress scientific notation.
-  ss << std::fixed << t;
-  auto s = ss.str();
-  // Sadly, std::fixed turns "1" into "1.00000", so here we undo that.
-  auto p = s.find_last_not_of('0');
-  if (p != std::string::npos) {
-    s.resize(p + 1);  // Strip trailing zeroes.
-    if (s[s.size() - 1] == '.')
-      s.erase(s.size() - 1, 1);  // Strip '.' if a whole number.
-  }
-  return s;
+  return util_internal::NumToString(t, std::true_type());
 }
 template<> inline std::string NumToString<float>(float t) {
-  return NumToString(static_cast<double>(t));
+  return util_internal::NumToString(t, std::true_type());
 }
 
 // Convert an integer value to a hexadecimal string.
 // The returned string length is always xdigits long, prefixed by 0 digits.
 // For example, IntToStringHex(0x23, 8) returns the string "00000023".
 inline std::string IntToStringHex(int i, int xdigits) {
-  std::stringstream ss;
-  ss << std::setw(xdigits)
-     << std::setfill('0')
-     << std::hex
-     << std::uppercase
-     << i;
-  return ss.str();
+  static const char kHexDigits[] = "0123456789ABCDEF";
+  char buf[sizeof(i) * 2];
+  auto p = buf + sizeof(buf);
+  auto u = static_cast<unsigned int>(i);
+  do {
+    *--p = kHexDigits[u & 15];
+    u >>= 4;
+  } while (u);
+  auto len = static_cast<int>(buf + sizeof(buf) - p);
+  std::string s(static_cast<size_t>(std::max(xdigits - len, 0)), '0');
+  return s.append(p, static_cast<size_t>(len));
 }
 
 // Portable implementation of strtoll().
 inline int64_t StringToInt(const char *str, char **endptr = nullptr, int base = 10) {
+  if (base == 10) {
+    // Fast path for decimals that can't overflow.
+    auto p = str;
+    auto negative = *p == '-';
+    if (negative || *p == '+') p++;
+    auto digits = p;
+    uint64_t u = 0;
+    while (*p >= '0' && *p <= '9' && p - digits < 18) u = u * 10 + *p++ - '0';
+    if (p != digits && !(*p >= '0' && *p <= '9')) {
+      if (endptr) *endptr = const_cast<char *>(p);
+      auto i = static_cast<int64_t>(u);
+      return negative ? -i : i;
+    }
+  }
   #ifdef _MSC_VER
     return _strtoi64(str, endptr, base);
   #else
@@ -112,6 +392,61 @@ inline int64_t StringToUInt(const char *str, char **endptr = nullptr, int base =
   #endif
 }
 
+// Like strtod(), but without its overhead for numbers with at most 15
+// significant digits and a decimal exponent within 22 of them: these convert
+// exactly with a single multiplication or division (Clinger's fast path).
+// Anything else goes through strtod().
+inline double StringToDouble(const char *str, char **endptr = nullptr) {
+  // Extended precision intermediates would round twice.
+  #if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+    static const double kPow10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    auto p = str;
+    auto negative = *p == '-';
+    if (negative || *p == '+') p++;
+    uint64_t significand = 0;
+    int num_digits = 0, significant_digits = 0, exponent = 0;
+    for (auto fraction = false; ; p++) {
+      if (*p >= '0' && *p <= '9') {
+        num_digits++;
+        if (significand || *p != '0') {
+          significand = significand * 10 + static_cast<uint64_t>(*p - '0');
+          significant_digits++;
+        }
+        if (fraction) exponent--;
+      } else if (*p == '.' && !fraction) {
+        fraction = true;
+      } else {
+        break;
+      }
+    }
+    auto fast = num_digits && significant_digits <= 15;
+    if (*p == 'e' || *p == 'E') {
+      auto e = p + 1;
+      auto negative_exponent = *e == '-';
+      if (negative_exponent || *e == '+') e++;
+      int exp10 = 0;
+      auto exponent_digits = e;
+      while (*e >= '0' && *e <= '9' && e - exponent_digits < 4)
+        exp10 = exp10 * 10 + *e++ - '0';
+      // Exponents without digits aren't part of the number, leave those
+      // (and very long exponents) to strtod().
+      fast = fast && e != exponent_digits && !(*e >= '0' && *e <= '9');
+      exponent += negative_exponent ? -exp10 : exp10;
+      p = e;
+    }
+    if (fast && exponent >= -22 && exponent <= 22 && *p != 'x' && *p != 'X') {
+      if (endptr) *endptr = const_cast<char *>(p);
+      auto d = static_cast<double>(significand);
+      d = exponent < 0 ? d / kPow10[-exponent] : d * kPow10[exponent];
+      return negative ? -d : d;
+    }
+  #endif
+  return strtod(str, endptr);
+}
+
 typedef bool (*LoadFileFunction)(const char *filename, bool binary,
                                  std::string *dest);
 typedef bool (*FileExistsFunction)(const char *filename);
@@ -131,9 +466,58 @@ bool DirExists(const char *name);
 // Load file "name" into "buf" returning true if successful
 // false otherwise.  If "binary" is false data is read
 // using ifstream's text mode, otherwise data is read with
-// no transcoding.
+// no transcoding (by default through a MappedFile, see below).
+// To access large binary files without copying them, use a
+// MappedFile directly.
 bool LoadFile(const char *name, bool binary, std::string *buf);
 
+// A read-only view of a file, mapped into memory rather than read. Pages are
+// only loaded when they are accessed, so opening even huge files is fast,
+// and FlatBuffers in them can be accessed directly with GetRoot().
+class MappedFile {
+ public:
+  // How the file is going to be accessed, for the OS to optimize for.
+  enum Advice {
+    kAdviceNormal,
+    kAdviceSequential,  // Read ahead aggressively, e.g. for reading a stream.
+    kAdviceRandom,  // Don't read ahead, e.g. for lookup tables.
+    kAdviceWillNeed,  // Start loading the whole file right away.
+  };
+
+  MappedFile() : data_(nullptr), size_(0) {}
+  ~MappedFile() { Close(); }
+
+  // Map file "name", returning true if successful, false otherwise.
+  // Any file mapped before is closed first.
+  bool Open(const char *name, Advice advice = kAdviceNormal);
+
+  void Close();
+
+  const uint8_t *GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+  // Get the root of a FlatBuffer in this file. Call Verify() first if the
+  // file may not be trusted.
+  template<typename T> const T *GetRoot() const {
+    return flatbuffers::GetRoot<T>(data_);
+  }
+
+  // Verify the file contains a valid FlatBuffer with root type T.
+  template<typename T> bool Verify(const char *identifier = nullptr) const {
+    if (!data_) return false;
+    Verifier verifier(data_, size_);
+    return verifier.VerifyBuffer<T>(identifier);
+  }
+
+ private:
+  // You shouldn't be copying instances of this class.
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  const uint8_t *data_;
+  size_t size_;
+};
+
 // Save data "buf" of length "len" bytes into a file
 // "name" returning true if successful, false otherwise.
 // If "binary" is false data is written using ifstream's
@@ -155,6 +539,104 @@ inline bool SaveFile(const char *name, const std::string &buf, bool binary) {
   return SaveFile(name, buf.c_str(), buf.size(), binary);
 }
 
+// Iterates over a sequence of size prefixed FlatBuffers (see
+// FlatBufferBuilder::FinishSizePrefixed()) stored back to back in memory,
+// e.g. a memory mapped file. Buffers are returned in place, without copying.
+class SizePrefixedBufferReader {
+ public:
+  SizePrefixedBufferReader(const uint8_t *data, size_t size)
+    : cur_(data), end_(data + size), truncated_(false) {}
+
+  // Get the next buffer: *buf points to its start (to be used with GetRoot()
+  // or a Verifier), *len is its size without the prefix.
+  // Returns false at the end of the data, or if the remaining data is too
+  // short for the size in its prefix (then Truncated() returns true).
+  bool Next(const uint8_t **buf, uoffset_t *len) {
+    if (cur_ == end_) return false;
+    auto left = static_cast<size_t>(end_ - cur_);
+    if (left < sizeof(uoffset_t) ||
+        GetPrefixedSize(cur_) > left - sizeof(uoffset_t)) {
+      truncated_ = true;
+      return false;
+    }
+    *len = GetPrefixedSize(cur_);
+    *buf = cur_ + sizeof(uoffset_t);
+    cur_ = *buf + *len;
+    return true;
+  }
+
+  bool Truncated() const { return truncated_; }
+
+ private:
+  const uint8_t *cur_;
+  const uint8_t *end_;
+  bool truncated_;
+};
+
+// Like SizePrefixedBufferReader, but reading from a file descriptor (a file,
+// pipe or socket). Data is read in large chunks, and buffers are returned
+// in place in the chunk, so they are only valid until the next call to Next().
+// Buffers larger than max_buffer_size are treated as an error, such that a
+// corrupt size prefix can't make this allocate an arbitrary amount of memory.
+// The file descriptor is not closed by this class.
+class SizePrefixedFileReader {
+ public:
+  explicit SizePrefixedFileReader(int fd, size_t chunk_size = 1 << 16,
+                                  size_t max_buffer_size = 1 << 28)
+    : fd_(fd), chunk_size_(chunk_size), max_buffer_size_(max_buffer_size),
+      start_(0), size_(0), error_(false), truncated_(false) {}
+
+  // Same as SizePrefixedBufferReader::Next(). Also returns false if reading
+  // fails or a buffer is larger than max_buffer_size (then Error() returns
+  // true).
+  bool Next(const uint8_t **buf, uoffset_t *len);
+
+  bool Error() const { return error_; }
+  bool Truncated() const { return truncated_; }
+
+ private:
+  // Read until at least size bytes are available at start_.
+  bool Fill(size_t size);
+
+  int fd_;
+  size_t chunk_size_;
+  size_t max_buffer_size_;
+  // Allocated as largest_scalar_t, to keep buffers in it aligned.
+  std::vector<largest_scalar_t> data_;
+  size_t start_;  // Start of the unread data.
+  size_t size_;  // End of the unread data.
+  bool error_;
+  bool truncated_;
+};
+
+// Writes a sequence of size prefixed FlatBuffers to a file descriptor, to be
+// read back by the readers above. Writes are buffered, call Flush() (or
+// destroy this object) to make sure everything is written.
+// The file descriptor is not closed by this class.
+class SizePrefixedFileWriter {
+ public:
+  explicit SizePrefixedFileWriter(int fd, size_t buffer_size = 1 << 16)
+    : fd_(fd), buffer_size_(buffer_size), error_(false) {}
+  ~SizePrefixedFileWriter() { Flush(); }
+
+  // Write a buffer finished with FlatBufferBuilder::FinishSizePrefixed().
+  bool Write(const uint8_t *buf, size_t len);
+  bool Write(const FlatBufferBuilder &fbb) {
+    return Write(fbb.GetBufferPointer(), fbb.GetSize());
+  }
+
+  // Returns false if any write so far failed.
+  bool Flush();
+
+ private:
+  bool WriteAll(const uint8_t *buf, size_t len);
+
+  int fd_;
+  size_t buffer_size_;
+  std::vector<uint8_t> buffer_;
+  bool error_;
+};
+
 // Functionality for minimalistic portable path handling:
 
 static const char kPosixPathSeparator = '/';
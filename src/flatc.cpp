@@ -111,6 +111,7 @@ static void Error(const std::string &err, bool usage, bool show_exe_name) {
       "                     non-UTF-8 input.)\n"
       "  --defaults-json    Output fields whose value is the default when\n"
       "                     writing JSON\n"
+      "  --compact-json     Output JSON without any whitespace.\n"
       "  --unknown-json     Allow fields in JSON that are not defined in the\n"
       "                     schema. These fields will be discared when generating\n"
       "                     binaries.\n"
@@ -127,13 +128,22 @@ static void Error(const std::string &err, bool usage, bool show_exe_name) {
       "  --gen-name-strings Generate type name functions for C++.\n"
       "  --escape-proto-ids Disable appending '_' in namespaces names.\n"
       "  --gen-object-api   Generate an additional object-based API\n"
+      "  --gen-json         Generate ToJson() and ParseJson() methods for C++,\n"
+      "                     that write and read JSON as the JSON options given\n"
+      "                     here specify.\n"
       "  --raw-binary       Allow binaries without file_indentifier to be read.\n"
       "                     This may crash flatc given a mismatched schema.\n"
       "  --proto            Input is a .proto, translate to .fbs.\n"
       "  --schema           Serialize schemas instead of JSON (use with -b)\n"
+      "  --bfbs-builtins    Add builtin attributes to the binary schema files.\n"
+      "                     Needed to parse JSON with them (hash, original_order).\n"
+      "  --json-stream      JSON files hold a stream of root objects (e.g.\n"
+      "                     newline delimited JSON). Use with -b, to write\n"
+      "                     them as a stream of size prefixed buffers.\n"
       "  --conform FILE     Specify a schema the following schemas should be\n"
       "                     an evolution of. Gives errors if not.\n"
-      "FILEs may be schemas, or JSON files (conforming to preceding schema)\n"
+      "FILEs may be schemas (.fbs, or binary .bfbs with -b/-t), or JSON files\n"
+      "(conforming to preceding schema)\n"
       "FILEs after the -- must be binary flatbuffer format files.\n"
       "Output files are named using the base file name of the input,\n"
       "and written to the current directory or the path given by -o.\n"
@@ -150,13 +160,52 @@ static void ParseFile(flatbuffers::Parser &parser, const std::string &filename,
   auto local_include_directory = flatbuffers::StripFileName(filename);
   include_directories.push_back(local_include_directory.c_str());
   include_directories.push_back(nullptr);
-  if (!parser.Parse(contents.c_str(), &include_directories[0],
-                     filename.c_str()))
+  if (!parser.ParseBuffer(contents.c_str(), contents.length(),
+                          &include_directories[0], filename.c_str()))
     Error(parser.error_, false, false);
   include_directories.pop_back();
   include_directories.pop_back();
 }
 
+static void LoadBinarySchema(flatbuffers::Parser &parser,
+                             const std::string &filename,
+                             const std::string &contents) {
+  auto buf = reinterpret_cast<const uint8_t *>(contents.c_str());
+  flatbuffers::Verifier verifier(buf, contents.length());
+  if (!reflection::VerifySchemaBuffer(verifier))
+    Error("not a valid binary schema: " + filename, false, false);
+  if (!parser.Deserialize(buf))
+    Error(filename + ": " + parser.error_, false, false);
+}
+
+// Converts a file holding a stream of JSON objects into a file holding a
+// stream of size prefixed binary buffers.
+static void ConvertJsonStream(flatbuffers::Parser &parser,
+                              const std::string &filename,
+                              const std::string &contents,
+                              const std::string &output_path) {
+  auto binary_filename = output_path +
+      flatbuffers::StripPath(flatbuffers::StripExtension(filename)) + "." +
+      (parser.file_extension_.length() ? parser.file_extension_ : "bin");
+  flatbuffers::EnsureDirExists(output_path);
+  auto out = fopen(binary_filename.c_str(), "wb");
+  if (!out) Error("unable to write file: " + binary_filename);
+  auto write_ok = true;
+  auto ok = parser.ParseJsonStream(contents.c_str(), contents.length(),
+      [&](const flatbuffers::FlatBufferBuilder &fbb) {
+        write_ok = fwrite(fbb.GetBufferPointer(), 1, fbb.GetSize(), out) ==
+                   fbb.GetSize();
+        return write_ok;
+      }, true);
+  if (fclose(out)) write_ok = false;
+  if (!ok || !write_ok) {
+    remove(binary_filename.c_str());  // Don't leave partial output behind.
+    Error(filename + ": " + (write_ok ? parser.error_
+                                      : "unable to write file: " +
+                                        binary_filename), false, false);
+  }
+}
+
 int main(int argc, const char *argv[]) {
   g_program_name = argv[0];
   flatbuffers::IDLOptions opts;
@@ -167,6 +216,7 @@ int main(int argc, const char *argv[]) {
   bool print_make_rules = false;
   bool raw_binary = false;
   bool schema_binary = false;
+  bool json_stream = false;
   std::vector<std::string> filenames;
   std::vector<const char *> include_directories;
   size_t binary_files_from = std::numeric_limits<size_t>::max();
@@ -193,6 +243,8 @@ int main(int argc, const char *argv[]) {
         opts.skip_js_exports = true;
       } else if(arg == "--defaults-json") {
         opts.output_default_scalars_in_json = true;
+      } else if(arg == "--compact-json") {
+        opts.compact_json = true;
       } else if (arg == "--unknown-json") {
         opts.skip_unexpected_fields_in_json = true;
       } else if(arg == "--no-prefix") {
@@ -208,6 +260,8 @@ int main(int argc, const char *argv[]) {
         opts.generate_name_strings = true;
       } else if(arg == "--gen-object-api") {
         opts.generate_object_based_api = true;
+      } else if(arg == "--gen-json") {
+        opts.generate_json = true;
       } else if(arg == "--gen-all") {
         opts.generate_all = true;
         opts.include_dependence_headers = false;
@@ -228,6 +282,10 @@ int main(int argc, const char *argv[]) {
         opts.escape_proto_identifiers = true;
       } else if(arg == "--schema") {
         schema_binary = true;
+      } else if(arg == "--bfbs-builtins") {
+        opts.binary_schema_builtins = true;
+      } else if(arg == "--json-stream") {
+        json_stream = true;
       } else if(arg == "-M") {
         print_make_rules = true;
       } else if(arg == "--version") {
@@ -260,12 +318,42 @@ int main(int argc, const char *argv[]) {
     Error("no options: specify at least one generator.", true);
   }
 
+  // Binary schemas lack the includes, doc comments and declaration order
+  // code generators need, so they only serve to convert data.
+  for (size_t i = 0; i < num_generators; ++i) {
+    if (!generator_enabled[i] ||
+        generators[i].generate == flatbuffers::GenerateBinary ||
+        generators[i].generate == flatbuffers::GenerateTextFile)
+      continue;
+    for (size_t f = 0; f < filenames.size() && f < binary_files_from; ++f) {
+      if (flatbuffers::GetExtension(filenames[f]) ==
+          reflection::SchemaExtension())
+        Error(std::string("cannot generate ") + generators[i].lang_name +
+              " from a binary schema: " + filenames[f], true);
+    }
+  }
+
+  if (json_stream) {
+    bool binary = false;
+    for (size_t i = 0; i < num_generators; ++i)
+      if (generator_enabled[i] &&
+          generators[i].generate == flatbuffers::GenerateBinary)
+        binary = true;
+    if (!binary) Error("--json-stream requires -b", true);
+  }
+
   flatbuffers::Parser conform_parser;
   if (!conform_to_schema.empty()) {
     std::string contents;
     if (!flatbuffers::LoadFile(conform_to_schema.c_str(), true, &contents))
       Error("unable to load schema: " + conform_to_schema);
-    ParseFile(conform_parser, conform_to_schema, contents, include_directories);
+    if (flatbuffers::GetExtension(conform_to_schema) ==
+        reflection::SchemaExtension()) {
+      LoadBinarySchema(conform_parser, conform_to_schema, contents);
+    } else {
+      ParseFile(conform_parser, conform_to_schema, contents,
+                include_directories);
+    }
   }
 
   // Now process the files:
@@ -305,11 +393,13 @@ int main(int argc, const char *argv[]) {
           }
         }
       } else {
-        // Check if file contains 0 bytes.
-        if (contents.length() != strlen(contents.c_str())) {
-          Error("input file appears to be binary: " + *file_it, true);
+        auto extension = flatbuffers::GetExtension(*file_it);
+        auto is_binary_schema = extension == reflection::SchemaExtension();
+        auto is_schema = extension == "fbs" || is_binary_schema;
+        if (json_stream && !is_schema) {
+          ConvertJsonStream(*g_parser, *file_it, contents, output_path);
+          continue;
         }
-        auto is_schema = flatbuffers::GetExtension(*file_it) == "fbs";
         if (is_schema) {
           // If we're processing multiple schemas, make sure to start each
           // one from scratch. If it depends on previous schemas it must do
@@ -317,7 +407,11 @@ int main(int argc, const char *argv[]) {
           delete g_parser;
           g_parser = new flatbuffers::Parser(opts);
         }
-        ParseFile(*g_parser, *file_it, contents, include_directories);
+        if (is_binary_schema) {
+          LoadBinarySchema(*g_parser, *file_it, contents);
+        } else {
+          ParseFile(*g_parser, *file_it, contents, include_directories);
+        }
         if (is_schema && !conform_to_schema.empty()) {
           auto err = g_parser->ConformTo(conform_parser);
           if (!err.empty()) Error("schemas don\'t conform: " + err);
@@ -69,7 +69,12 @@ class CppGenerator : public BaseGenerator {
     code += "#ifndef " + include_guard + "\n";
     code += "#define " + include_guard + "\n\n";
 
-    code += "#include \"flatbuffers/flatbuffers.h\"\n\n";
+    code += "#include \"flatbuffers/flatbuffers.h\"\n";
+    if (parser_.opts.generate_json) {
+      code += "#include \"flatbuffers/hash.h\"\n";
+      code += "#include \"flatbuffers/json.h\"\n";
+    }
+    code += "\n";
 
     if (parser_.opts.include_dependence_headers) {
       int num_includes = 0;
@@ -138,6 +143,19 @@ class CppGenerator : public BaseGenerator {
       }
     }
 
+    // Generate JSON output and parsing for all structs and tables.
+    if (parser_.opts.generate_json) {
+      for (auto it = parser_.structs_.vec.begin();
+           it != parser_.structs_.vec.end(); ++it) {
+        auto &struct_def = **it;
+        if (!struct_def.generated) {
+          SetNameSpace(struct_def.defined_namespace, &code);
+          GenToJson(struct_def, &code);
+          GenParseJson(struct_def, &code);
+        }
+      }
+    }
+
     // Generate code for union verifiers.
     for (auto it = parser_.enums_.vec.begin(); it != parser_.enums_.vec.end();
          ++it) {
@@ -504,6 +522,8 @@ class CppGenerator : public BaseGenerator {
     if (enum_def.is_union) {
       code += UnionVerifySignature(enum_def) + ";\n\n";
     }
+
+    if (parser_.opts.generate_json) GenEnumValueLookup(enum_def, code_ptr);
   }
 
   void GenUnionPost(EnumDef &enum_def, std::string *code_ptr) {
@@ -833,6 +853,18 @@ class CppGenerator : public BaseGenerator {
       code += "  " + TableUnPackSignature(struct_def, true) + ";\n";
     }
 
+    if (parser_.opts.generate_json) {
+      // Generate the ToJson() and ParseJson() pre declarations.
+      code += "  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) "
+              "const;\n";
+      code += "  static bool ParseJson(flatbuffers::JsonScanner &json,\n";
+      code += "      flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<";
+      code += struct_def.name + "> *result);\n";
+      code += "  static bool ParseJson(const char *json, size_t length,\n";
+      code += "      flatbuffers::FlatBufferBuilder &fbb, "
+              "std::string *error = nullptr);\n";
+    }
+
     code += "};\n\n";  // End of table.
 
     // Generate a builder struct, with methods of the form:
@@ -1124,6 +1156,548 @@ class CppGenerator : public BaseGenerator {
     }
   }
 
+  // Returns s as a C++ string literal.
+  static std::string GenStringLiteral(const std::string &s) {
+    std::string literal = "\"";
+    for (auto it = s.begin(); it != s.end(); ++it) {
+      if (*it == '\n') {
+        literal += "\\n";
+      } else {
+        if (*it == '"' || *it == '\\') literal += '\\';
+        literal += *it;
+      }
+    }
+    return literal + "\"";
+  }
+
+  // The JSON layout follows GenerateText() (see idl_gen_text.cpp) with the
+  // options given to flatc, so it is fixed at compile time.
+  std::string JsonNewLine() {
+    return parser_.opts.indent_step >= 0 && !parser_.opts.compact_json
+           ? "\n" : "";
+  }
+
+  int JsonIndentStep() {
+    return parser_.opts.compact_json ? 0 : std::max(parser_.opts.indent_step, 0);
+  }
+
+  std::string JsonIdentifier(const std::string &name) {
+    return parser_.opts.strict_json ? "\"" + name + "\"" : name;
+  }
+
+  // The indentation of values nested levels deep in the current one.
+  std::string JsonIndent(int levels) {
+    if (!JsonIndentStep()) return "0";
+    if (!levels) return "indent";
+    return "indent + " + NumToString(levels * JsonIndentStep());
+  }
+
+  // Appends with the length known, since this is most of what ToJson() does.
+  std::string GenJsonAppend(const std::string &text, const std::string &lead) {
+    if (text.empty()) return "";
+    if (text.size() == 1) {
+      return lead + "sink += '" + (text == "\n" ? "\\n" : text) + "';\n";
+    }
+    return lead + "sink.Append(" + GenStringLiteral(text) + ", " +
+           NumToString(text.size()) + ");\n";
+  }
+
+  std::string GenJsonFill(int levels, const std::string &lead) {
+    return JsonIndentStep()
+           ? lead + "sink.Fill(" + JsonIndent(levels) + ", ' ');\n" : "";
+  }
+
+  // Generate statements that write val, a variable of the given type, as
+  // JSON, levels deep. utype is the type of a union value.
+  void GenJsonValue(const Type &type, const std::string &val, int levels,
+                    const std::string &utype, const std::string &lead,
+                    std::string *code_ptr) {
+    std::string &code = *code_ptr;
+    switch (type.base_type) {
+      case BASE_TYPE_BOOL:
+        code += lead + "sink += " + val + " != 0 ? \"true\" : \"false\";\n";
+        break;
+      case BASE_TYPE_STRING:
+        code += lead + "if (!flatbuffers::EscapeJsonString(" + val;
+        code += "->c_str(), " + val + "->size(), ";
+        code += parser_.opts.allow_non_utf8 ? "true" : "false";
+        code += ", &sink)) return false;\n";
+        break;
+      case BASE_TYPE_STRUCT:
+        code += lead + "if (!" + val + "->ToJson(sink, " + JsonIndent(levels);
+        code += ")) return false;\n";
+        break;
+      case BASE_TYPE_UNION: {
+        code += lead + "switch (" + utype + ") {\n";
+        auto &vals = type.enum_def->vals.vec;
+        for (auto it = vals.begin() + 1; it != vals.end(); ++it) {
+          auto &ev = **it;
+          if (!ev.struct_def) continue;
+          code += lead + "  case " + NumToString(ev.value) + ":\n";
+          code += lead + "    if (!static_cast<const ";
+          code += WrapInNameSpace(*ev.struct_def) + " *>(" + val;
+          code += ")->ToJson(sink, " + JsonIndent(levels) + ")) return false;\n";
+          code += lead + "    break;\n";
+        }
+        code += lead + "  default: return false;\n";
+        code += lead + "}\n";
+        break;
+      }
+      case BASE_TYPE_VECTOR: {
+        code += GenJsonAppend("[" + JsonNewLine(), lead);
+        code += lead + "for (flatbuffers::uoffset_t _i = 0; _i < " + val;
+        code += "->size(); _i++) {\n";
+        code += lead + "  if (_i) sink += ";
+        code += GenStringLiteral("," + JsonNewLine()) + ";\n";
+        code += GenJsonFill(levels + 1, lead + "  ");
+        code += lead + "  auto _e = " + val + "->Get(_i);\n";
+        GenJsonValue(type.VectorType(), "_e", levels + 1, "", lead + "  ",
+                     code_ptr);
+        code += lead + "}\n";
+        code += GenJsonAppend(JsonNewLine(), lead);
+        code += GenJsonFill(levels, lead);
+        code += GenJsonAppend("]", lead);
+        break;
+      }
+      default:
+        if (type.enum_def && parser_.opts.output_enum_identifiers) {
+          // Like EnumDef::ReverseLookup(), which is what GenerateText() uses.
+          code += lead + "switch (static_cast<int>(" + val + ")) {\n";
+          auto &enum_def = *type.enum_def;
+          std::set<int64_t> seen;
+          for (auto it = enum_def.vals.vec.begin() +
+                         static_cast<int>(enum_def.is_union);
+               it != enum_def.vals.vec.end(); ++it) {
+            auto &ev = **it;
+            if (static_cast<int>(ev.value) != ev.value ||  // Can't match.
+                !seen.insert(ev.value).second)
+              continue;
+            code += lead + "  case " + NumToString(ev.value) + ":\n";
+            code += GenJsonAppend(JsonIdentifier(ev.name), lead + "    ");
+            code += lead + "    break;\n";
+          }
+          code += lead + "  default: sink.AppendNumber(" + val + ");\n";
+          code += lead + "}\n";
+        } else {
+          code += lead + "sink.AppendNumber(" + val + ");\n";
+        }
+        break;
+    }
+  }
+
+  // Generate the ToJson() method of a table or struct.
+  void GenToJson(const StructDef &struct_def, std::string *code_ptr) {
+    std::string &code = *code_ptr;
+    auto &opts = parser_.opts;
+    code += "inline bool " + struct_def.name;
+    code += "::ToJson(flatbuffers::TextSink &sink, int ";
+    code += JsonIndentStep() ? "indent" : "/*indent*/";
+    code += ") const {\n";
+    code += GenJsonAppend("{", "  ");
+    auto &fields = struct_def.fields.vec;
+    if (!struct_def.fixed && !fields.empty()) {
+      code += "  auto _sep = " + GenStringLiteral(JsonNewLine()) + ";\n";
+    }
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+      auto &field = **it;
+      auto &type = field.value.type;
+      // Deprecated fields have no accessors, but are still written when
+      // present.
+      auto offset = field.deprecated ? NumToString(field.value.offset)
+                                     : GenFieldOffsetName(field);
+      auto output_anyway = !struct_def.fixed &&
+                           opts.output_default_scalars_in_json &&
+                           IsScalar(type.base_type) && !field.deprecated;
+      std::string lead = "    ";
+      if (struct_def.fixed) {
+        code += "  {\n";
+        code += GenJsonAppend(
+            (it == fields.begin() ? "" : ",") + JsonNewLine(), lead);
+      } else {
+        code += output_anyway ? "  {\n" : "  if (CheckField(" + offset + ")) {\n";
+        code += lead + "sink += _sep;\n";
+        code += lead + "_sep = " + GenStringLiteral("," + JsonNewLine()) + ";\n";
+      }
+      code += GenJsonFill(1, lead);
+      code += GenJsonAppend(JsonIdentifier(field.name) +
+                            (opts.compact_json ? ":" : ": "), lead);
+      std::string utype;
+      if (type.base_type == BASE_TYPE_UNION) {
+        auto type_field = struct_def.fields.Lookup(field.name +
+                                                   UnionTypeFieldSuffix());
+        assert(type_field);
+        utype = "GetField<uint8_t>(" +
+                (type_field->deprecated ? NumToString(type_field->value.offset)
+                                        : GenFieldOffsetName(*type_field)) +
+                ", 0)";
+      }
+      code += lead + "auto _v = ";
+      if (struct_def.fixed) {
+        code += IsScalar(type.base_type)
+                ? "flatbuffers::EndianScalar(" + field.name + "_)"
+                : "&" + field.name + "_";
+      } else if (IsScalar(type.base_type)) {
+        // Absent fields are only output with their default value.
+        code += "GetField<" + GenTypeBasic(type, false) + ">(" + offset + ", ";
+        code += (output_anyway ? GenDefaultConstant(field) : "0") + ")";
+      } else {
+        code += IsStruct(type) ? "GetStruct<" : "GetPointer<";
+        code += GenTypeGet(type, "", "const ", " *", false) + ">(" + offset + ")";
+      }
+      code += ";\n";
+      GenJsonValue(type, "_v", 1, utype, lead, code_ptr);
+      code += "  }\n";
+    }
+    code += GenJsonAppend(JsonNewLine(), "  ");
+    code += GenJsonFill(0, "  ");
+    code += GenJsonAppend("}", "  ");
+    code += "  return true;\n";
+    code += "}\n\n";
+  }
+
+  // Generate a switch on the length of the name, that runs the statement
+  // paired with the name it is equal to, if any. This is how the JSON
+  // parsing code looks up names, without any tables at runtime.
+  static std::string GenNameSwitch(
+      std::vector<std::pair<std::string, std::string>> cases,
+      const std::string &name, const std::string &length,
+      const std::string &lead) {
+    std::stable_sort(cases.begin(), cases.end(),
+                     [](const std::pair<std::string, std::string> &a,
+                        const std::pair<std::string, std::string> &b) {
+                       return a.first.size() < b.first.size();
+                     });
+    std::string code = lead + "switch (" + length + ") {\n";
+    for (auto it = cases.begin(); it != cases.end(); ++it) {
+      auto size = NumToString(it->first.size());
+      auto first = it == cases.begin() ||
+                   (it - 1)->first.size() != it->first.size();
+      if (first) code += lead + "  case " + size + ":\n" + lead + "    if";
+      else code += lead + "    else if";
+      code += " (!memcmp(" + name + ", " + GenStringLiteral(it->first);
+      code += ", " + size + ")) " + it->second + "\n";
+      if (it + 1 == cases.end() || (it + 1)->first.size() != it->first.size())
+        code += lead + "    break;\n";
+    }
+    return code + lead + "}\n";
+  }
+
+  // Generate the function that looks up the values of an enum by name, for
+  // the JSON parsing code.
+  void GenEnumValueLookup(const EnumDef &enum_def, std::string *code_ptr) {
+    std::string &code = *code_ptr;
+    std::vector<std::pair<std::string, std::string>> cases;
+    for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
+         ++it) {
+      cases.push_back(std::make_pair((*it)->name, "{ *value = " +
+                                     NumToString((*it)->value) +
+                                     "; return true; }"));
+    }
+    code += "inline bool EnumValue" + enum_def.name;
+    code += "(const char *name, size_t length, int64_t *value) {\n";
+    code += GenNameSwitch(cases, "name", "length", "  ");
+    code += "  return false;\n}\n\n";
+  }
+
+  // The C++ type a value of this type is parsed into, see GenParseJsonValue().
+  std::string GenParseJsonType(const Type &type) {
+    return IsStruct(type) ? WrapInNameSpace(*type.struct_def)
+                          : GenTypeWire(type, "", false);
+  }
+
+  // Generate statements that parse a JSON value of the given type into dest,
+  // a variable of GenParseJsonType(). Unions are handled in GenParseJson().
+  void GenParseJsonValue(const Type &type, const FieldDef *field,
+                         const std::string &dest, const std::string &lead,
+                         std::string *code_ptr) {
+    std::string &code = *code_ptr;
+    switch (type.base_type) {
+      case BASE_TYPE_STRING:
+        code += lead + "if (!json.ParseString(";
+        code += parser_.opts.allow_non_utf8 ? "true" : "false";
+        code += ", fbb, &" + dest + ")) return false;\n";
+        break;
+      case BASE_TYPE_STRUCT:
+        code += lead + "if (!" + WrapInNameSpace(*type.struct_def);
+        code += "::ParseJson(json, ";
+        if (!type.struct_def->fixed) code += "fbb, ";
+        code += "&" + dest + ")) return false;\n";
+        break;
+      case BASE_TYPE_VECTOR: {
+        auto vector_type = type.VectorType();
+        code += lead + "std::vector<" + GenParseJsonType(vector_type);
+        code += "> v;\n";
+        code += lead + "if (!json.Expect('[')) return false;\n";
+        code += lead + "for (bool elements = !json.Is(']'); elements; ) {\n";
+        code += lead + "  " + GenParseJsonType(vector_type) + " e;\n";
+        GenParseJsonValue(vector_type, nullptr, "e", lead + "  ", code_ptr);
+        code += lead + "  v.push_back(e);\n";
+        code += lead + "  if (!json.Is(',')) break;\n";
+        code += lead + "  if (!json.Next()) return false;\n";
+        if (!parser_.opts.strict_json)
+          code += lead + "  elements = !json.Is(']');\n";
+        code += lead + "}\n";
+        code += lead + "if (!json.Expect(']')) return false;\n";
+        code += lead + dest + " = fbb.CreateVector";
+        if (IsStruct(vector_type)) code += "OfStructs";
+        code += "(v);\n";
+        break;
+      }
+      case BASE_TYPE_FLOAT:
+      case BASE_TYPE_DOUBLE:
+        code += lead + "double d;\n";
+        code += lead + "if (!json.ParseFloat(&d)) return false;\n";
+        code += lead + dest + " = ";
+        code += type.base_type == BASE_TYPE_FLOAT ? "static_cast<float>(d);\n"
+                                                  : "d;\n";
+        break;
+      default: {
+        auto bits = type.base_type == BASE_TYPE_BOOL
+                    ? 64 : SizeOf(type.base_type) * 8;
+        auto hash = field ? field->attributes.Lookup("hash") : nullptr;
+        code += lead + "int64_t i;\n";
+        if (hash) {
+          auto &name = hash->constant;
+          code += lead + "if (!json.ParseHash(flatbuffers::HashFnv1";
+          if (name.find("fnv1a") == 0) code += "a";
+          code += name.find("_64") != std::string::npos ? "<uint64_t>"
+                                                       : "<uint32_t>";
+        } else {
+          code += lead + "if (!json.ParseInteger(";
+          code += type.enum_def
+                  ? WrapInNameSpace(type.enum_def->defined_namespace,
+                                    "EnumValue" + type.enum_def->name)
+                  : "nullptr";
+        }
+        code += ", " + NumToString(bits) + ", &i)) return false;\n";
+        if (type.base_type == BASE_TYPE_BOOL) {
+          code += lead + dest + " = i != 0;\n";
+        } else {
+          code += lead + dest + " = static_cast<" + GenTypeBasic(type, false);
+          code += ">(i);\n";
+        }
+        break;
+      }
+    }
+  }
+
+  // Generate the ParseJson() methods of a table or struct. They accept what
+  // the Parser does with the options given to flatc, and build the same
+  // FlatBuffer, but the schema is compiled in.
+  void GenParseJson(const StructDef &struct_def, std::string *code_ptr) {
+    std::string &code = *code_ptr;
+    auto &opts = parser_.opts;
+    auto &fields = struct_def.fields.vec;
+    code += "inline bool " + struct_def.name;
+    code += "::ParseJson(flatbuffers::JsonScanner &json,";
+    if (struct_def.fixed) {
+      code += " " + struct_def.name + " *result) {\n";
+    } else {
+      code += "\n    flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<";
+      code += struct_def.name + "> *result) {\n";
+    }
+    // Values are kept here until the object can be built.
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+      auto &field = **it;
+      code += "  " + GenParseJsonType(field.value.type) + " _" + field.name;
+      if (IsScalar(field.value.type.base_type)) code += " = 0";
+      code += ";\n";
+    }
+    if (!fields.empty()) {
+      code += "  bool set[" + NumToString(fields.size()) + "] = {};\n";
+    }
+    if (struct_def.fixed) code += "  size_t count = 0;\n";
+    code += "  if (!json.Expect('{')) return false;\n";
+    code += "  for (bool more = !json.Is('}'); more; ) {\n";
+    code += "    const char *key = nullptr;\n";
+    code += "    size_t key_length = 0;\n";
+    code += "    if (!json.ParseFieldName(";
+    code += opts.strict_json ? "true" : "false";
+    code += ", &key, &key_length)) return false;\n";
+    std::string unknown = opts.skip_unexpected_fields_in_json
+        ? "if (!json.Expect(':') || !json.SkipValue()) return false;"
+        : "return json.Error(\"unknown field: \" + "
+          "std::string(key, key_length));";
+    if (fields.empty()) {
+      code += "    " + unknown + "\n";
+      if (!opts.skip_unexpected_fields_in_json) {
+        // Any field is an error, so the loop never gets past one.
+        code += "  }\n";
+      }
+    } else {
+      std::vector<std::pair<std::string, std::string>> cases;
+      for (auto it = fields.begin(); it != fields.end(); ++it) {
+        cases.push_back(std::make_pair((*it)->name, "field = " +
+                                       NumToString((*it)->index) + ";"));
+      }
+      code += "    int field = -1;\n";
+      code += GenNameSwitch(cases, "key", "key_length", "    ");
+      code += "    if (field < 0) {\n";
+      code += "      " + unknown + "\n";
+      code += "    } else if (!json.Expect(':')) {\n";
+      code += "      return false;\n";
+      // As in the Parser, null doesn't set the field, so may come before or
+      // after a value for it.
+      code += "    } else if (json.Is(flatbuffers::JsonScanner::kTokenNull)) {\n";
+      code += "      if (!json.Next()) return false;  // Ignore this field.\n";
+      code += "    } else if (set[field]) {\n";
+      code += "      return json.Error(\"field set more than once: \" +\n";
+      code += "                        std::string(key, key_length));\n";
+      code += "    } else {\n";
+      code += "      switch (field) {\n";
+      for (auto it = fields.begin(); it != fields.end(); ++it) {
+        auto &field = **it;
+        auto &type = field.value.type;
+        code += "        case " + NumToString(field.index) + ": {\n";
+        if (type.base_type != BASE_TYPE_UNION) {
+          GenParseJsonValue(type, &field, "_" + field.name, "          ",
+                            code_ptr);
+          code += "          break;\n";
+          code += "        }\n";
+          continue;
+        }
+        // Unions need their type, which JSON writers that sort keys put
+        // after them: in that case the value is recorded while scanning past
+        // it to the type, then parsed from the recording, as the Parser does.
+        auto type_name = field.name + UnionTypeFieldSuffix();
+        auto type_field = struct_def.fields.Lookup(type_name);
+        assert(type_field);
+        auto type_index = NumToString(type_field->index);
+        code += "          auto type = _" + type_name + ";\n";
+        code += "          auto after = json.Save();\n";
+        code += "          if (!set[" + type_index + "]) {\n";
+        code += "            size_t value;\n";
+        code += "            if (!json.RecordValue(&value)) return false;\n";
+        code += "            after = json.Save();\n";
+        code += "            if (!json.Expect(',') ||\n";
+        code += "                !json.ParseFieldName(";
+        code += opts.strict_json ? "true" : "false";
+        code += ", &key, &key_length))\n";
+        code += "              return false;\n";
+        code += "            if (key_length != " +
+                NumToString(type_name.size()) + " || memcmp(key, " +
+                GenStringLiteral(type_name) + ", key_length))\n";
+        code += "              return json.Error(\"missing type field after "
+                "this union value: " + type_name + "\");\n";
+        code += "            if (!json.Expect(':')) return false;\n";
+        GenParseJsonValue(type_field->value.type, type_field, "type",
+                          "            ", code_ptr);
+        code += "            if (!json.Replay(value)) return false;\n";
+        code += "          }\n";
+        code += "          switch (type) {\n";
+        auto &vals = type.enum_def->vals.vec;
+        for (auto ev_it = vals.begin(); ev_it != vals.end(); ++ev_it) {
+          auto &ev = **ev_it;
+          if (!ev.struct_def) continue;
+          code += "            case " + NumToString(ev.value) + ": {\n";
+          code += "              flatbuffers::Offset<" +
+                  WrapInNameSpace(*ev.struct_def) + "> table;\n";
+          code += "              if (!" + WrapInNameSpace(*ev.struct_def);
+          code += "::ParseJson(json, fbb, &table)) return false;\n";
+          code += "              _" + field.name + " = table.Union();\n";
+          code += "              break;\n";
+          code += "            }\n";
+        }
+        code += "            default:\n";
+        code += "              return json.Error(\"illegal type id for: " +
+                field.name + "\");\n";
+        code += "          }\n";
+        code += "          if (!set[" + type_index + "]) json.Restore(after);\n";
+        code += "          break;\n";
+        code += "        }\n";
+      }
+      code += "      }\n";
+      code += "      set[field] = true;\n";
+      if (struct_def.fixed) code += "      count++;\n";
+      code += "    }\n";
+    }
+    if (!fields.empty() || opts.skip_unexpected_fields_in_json) {
+      code += "    if (!json.Is(',')) break;\n";
+      code += "    if (!json.Next()) return false;\n";
+      if (!opts.strict_json) code += "    more = !json.Is('}');\n";
+      code += "  }\n";
+    }
+    code += "  if (!json.Expect('}')) return false;\n";
+    if (struct_def.fixed) {
+      code += "  if (count != " + NumToString(fields.size()) + ")\n";
+      code += "    return json.Error(\"struct: wrong number of initializers: ";
+      code += struct_def.name + "\");\n";
+      code += "  " + struct_def.name + " value(";
+      for (auto it = fields.begin(); it != fields.end(); ++it) {
+        if (it != fields.begin()) code += ", ";
+        code += GenUnderlyingCast(**it, true, "_" + (*it)->name);
+      }
+      code += ");\n";
+      code += "  *result = value;\n";
+      code += "  return true;\n";
+      code += "}\n\n";
+      return;
+    }
+    // Unlike the Parser, which leaves these to the verifier, reject missing
+    // required fields: Builder::Finish() asserts on them in debug builds.
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+      auto &field = **it;
+      if (field.required && !field.deprecated) {
+        code += "  if (!set[" + NumToString(field.index) + "])\n";
+        code += "    return json.Error(\"missing required field: ";
+        code += field.name + "\");\n";
+      }
+    }
+    // Fields are added in the order the Parser adds them in (the same as
+    // CreateX()). The FlatBuffer holds the same data, but is not always
+    // byte-identical: the Parser also aligns while parsing nested structs.
+    code += "  " + struct_def.name + "Builder builder_(fbb);\n";
+    for (size_t size = struct_def.sortbysize ? sizeof(largest_scalar_t) : 1;
+         size; size /= 2) {
+      for (auto it = fields.rbegin(); it != fields.rend(); ++it) {
+        auto &field = **it;
+        auto &type = field.value.type;
+        if (struct_def.sortbysize && size != SizeOf(type.base_type)) continue;
+        code += "  if (set[" + NumToString(field.index) + "]) ";
+        auto value = IsStruct(type) ? "&_" + field.name : "_" + field.name;
+        if (field.deprecated) {
+          // These have no add_ method.
+          code += "builder_.fbb_.Add";
+          if (IsScalar(type.base_type)) {
+            code += "Element<" + GenTypeBasic(type, false) + ">";
+          } else {
+            code += IsStruct(type) ? "Struct" : "Offset";
+          }
+          code += "(" + NumToString(field.value.offset) + ", " + value;
+          if (IsScalar(type.base_type)) code += ", " + GenDefaultConstant(field);
+          code += ");\n";
+        } else {
+          code += "builder_.add_" + field.name + "(";
+          code += GenUnderlyingCast(field, true, value) + ");\n";
+        }
+      }
+    }
+    code += "  *result = builder_.Finish();\n";
+    code += "  return true;\n";
+    code += "}\n\n";
+
+    code += "inline bool " + struct_def.name;
+    code += "::ParseJson(const char *json, size_t length,\n";
+    code += "    flatbuffers::FlatBufferBuilder &fbb, std::string *error) {\n";
+    code += "  flatbuffers::JsonScanner scanner(json, length);\n";
+    code += "  flatbuffers::Offset<" + struct_def.name + "> root;\n";
+    code += "  if (scanner.Next() && ParseJson(scanner, fbb, &root)) {\n";
+    code += "    if (scanner.Is(flatbuffers::JsonScanner::kTokenEof)) {\n";
+    code += "      fbb.Finish(root";
+    if (&struct_def == parser_.root_struct_def_ &&
+        parser_.file_identifier_.length()) {
+      code += ", " + GenStringLiteral(parser_.file_identifier_);
+    }
+    code += ");\n";
+    code += "      return true;\n";
+    code += "    }\n";
+    code += "    scanner.Error(\"cannot have more than one json object\");\n";
+    code += "  }\n";
+    code += "  if (error) *error = scanner.error();\n";
+    code += "  return false;\n";
+    code += "}\n\n";
+  }
+
   static void GenPadding(const FieldDef &field, std::string &code,
                          int &padding_id,
                          const std::function<void(int bits, std::string &code,
@@ -1186,6 +1760,9 @@ class CppGenerator : public BaseGenerator {
     code += "  " + struct_def.name + "(const " + struct_def.name;
     code += " &_o) { memcpy(this, &_o, sizeof(";
     code += struct_def.name + ")); }\n";
+    // Declared, since the implicit one is deprecated next to the above.
+    code += "  " + struct_def.name + " &operator=(const " + struct_def.name;
+    code += " &) = default;\n";
 
     // Generate a constructor that takes all fields as arguments.
     code += "  " + struct_def.name + "(";
@@ -1252,6 +1829,13 @@ class CppGenerator : public BaseGenerator {
         }
       }
     }
+    if (parser_.opts.generate_json) {
+      // Generate the ToJson() and ParseJson() pre declarations.
+      code += "  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) "
+              "const;\n";
+      code += "  static bool ParseJson(flatbuffers::JsonScanner &json, ";
+      code += struct_def.name + " *result);\n";
+    }
     code += "};\nSTRUCT_END(" + struct_def.name + ", ";
     code += NumToString(struct_def.bytesize) + ");\n\n";
   }
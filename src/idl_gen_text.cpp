@@ -18,28 +18,34 @@
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/json.h"
 #include "flatbuffers/util.h"
 
 namespace flatbuffers {
 
 static bool GenStruct(const StructDef &struct_def, const Table *table,
                       int indent, const IDLOptions &opts,
-                      std::string *_text);
+                      TextSink *_text);
 
 // If indentation is less than 0, that indicates we don't want any newlines
 // either.
 const char *NewLine(const IDLOptions &opts) {
-  return opts.indent_step >= 0 ? "\n" : "";
+  return opts.indent_step >= 0 && !opts.compact_json ? "\n" : "";
 }
 
 int Indent(const IDLOptions &opts) {
-  return std::max(opts.indent_step, 0);
+  return opts.compact_json ? 0 : std::max(opts.indent_step, 0);
+}
+
+// Goes between a field name and its value.
+const char *NameSeparator(const IDLOptions &opts) {
+  return opts.compact_json ? ":" : ": ";
 }
 
 // Output an identifier with or without quotes depending on strictness.
 void OutputIdentifier(const std::string &name, const IDLOptions &opts,
-                      std::string *_text) {
-  std::string &text = *_text;
+                      TextSink *_text) {
+  TextSink &text = *_text;
   if (opts.strict_json) text += "\"";
   text += name;
   if (opts.strict_json) text += "\"";
@@ -51,8 +57,8 @@ void OutputIdentifier(const std::string &name, const IDLOptions &opts,
 template<typename T> bool Print(T val, Type type, int /*indent*/,
                                 StructDef * /*union_sd*/,
                                 const IDLOptions &opts,
-                                std::string *_text) {
-  std::string &text = *_text;
+                                TextSink *_text) {
+  TextSink &text = *_text;
   if (type.enum_def && opts.output_enum_identifiers) {
     auto enum_val = type.enum_def->ReverseLookup(static_cast<int>(val));
     if (enum_val) {
@@ -64,7 +70,7 @@ template<typename T> bool Print(T val, Type type, int /*indent*/,
   if (type.base_type == BASE_TYPE_BOOL) {
     text += val != 0 ? "true" : "false";
   } else {
-    text += NumToString(val);
+    text.AppendNumber(val);
   }
 
   return true;
@@ -73,8 +79,8 @@ template<typename T> bool Print(T val, Type type, int /*indent*/,
 // Print a vector a sequence of JSON values, comma separated, wrapped in "[]".
 template<typename T> bool PrintVector(const Vector<T> &v, Type type,
                                       int indent, const IDLOptions &opts,
-                                      std::string *_text) {
-  std::string &text = *_text;
+                                      TextSink *_text) {
+  TextSink &text = *_text;
   text += "[";
   text += NewLine(opts);
   for (uoffset_t i = 0; i < v.size(); i++) {
@@ -82,7 +88,7 @@ template<typename T> bool PrintVector(const Vector<T> &v, Type type,
       text += ",";
       text += NewLine(opts);
     }
-    text.append(indent + Indent(opts), ' ');
+    text.Fill(indent + Indent(opts), ' ');
     if (IsStruct(type)) {
       if (!Print(v.GetStructFromOffset(i * type.struct_def->bytesize), type,
                  indent + Indent(opts), nullptr, opts, _text)) {
@@ -96,82 +102,17 @@ template<typename T> bool PrintVector(const Vector<T> &v, Type type,
     }
   }
   text += NewLine(opts);
-  text.append(indent, ' ');
+  text.Fill(indent, ' ');
   text += "]";
   return true;
 }
 
-static bool EscapeString(const String &s, std::string *_text, const IDLOptions& opts) {
-  std::string &text = *_text;
-  text += "\"";
-  for (uoffset_t i = 0; i < s.size(); i++) {
-    char c = s[i];
-    switch (c) {
-      case '\n': text += "\\n"; break;
-      case '\t': text += "\\t"; break;
-      case '\r': text += "\\r"; break;
-      case '\b': text += "\\b"; break;
-      case '\f': text += "\\f"; break;
-      case '\"': text += "\\\""; break;
-      case '\\': text += "\\\\"; break;
-      default:
-        if (c >= ' ' && c <= '~') {
-          text += c;
-        } else {
-          // Not printable ASCII data. Let's see if it's valid UTF-8 first:
-          const char *utf8 = s.c_str() + i;
-          int ucc = FromUTF8(&utf8);
-          if (ucc < 0) {
-            if (opts.allow_non_utf8) {
-              text += "\\x";
-              text += IntToStringHex(static_cast<uint8_t>(c), 2);
-            } else {
-              // There are two cases here:
-              //
-              // 1) We reached here by parsing an IDL file. In that case,
-              // we previously checked for non-UTF-8, so we shouldn't reach
-              // here.
-              //
-              // 2) We reached here by someone calling GenerateText()
-              // on a previously-serialized flatbuffer. The data might have
-              // non-UTF-8 Strings, or might be corrupt.
-              //
-              // In both cases, we have to give up and inform the caller
-              // they have no JSON.
-              return false;
-            }
-          } else {
-            if (ucc <= 0xFFFF) {
-              // Parses as Unicode within JSON's \uXXXX range, so use that.
-              text += "\\u";
-              text += IntToStringHex(ucc, 4);
-            } else if (ucc <= 0x10FFFF) {
-              // Encode Unicode SMP values to a surrogate pair using two \u escapes.
-              uint32_t base = ucc - 0x10000;
-              uint16_t highSurrogate = (base >> 10) + 0xD800;
-              uint16_t lowSurrogate = (base & 0x03FF) + 0xDC00;
-              text += "\\u";
-              text += IntToStringHex(highSurrogate, 4);
-              text += "\\u";
-              text += IntToStringHex(lowSurrogate, 4);
-            }
-            // Skip past characters recognized.
-            i = static_cast<uoffset_t>(utf8 - s.c_str() - 1);
-          }
-        }
-        break;
-    }
-  }
-  text += "\"";
-  return true;
-}
-
 // Specialization of Print above for pointer types.
 template<> bool Print<const void *>(const void *val,
                                     Type type, int indent,
                                     StructDef *union_sd,
                                     const IDLOptions &opts,
-                                    std::string *_text) {
+                                    TextSink *_text) {
   switch (type.base_type) {
     case BASE_TYPE_UNION:
       // If this assert hits, you have an corrupt buffer, a union type field
@@ -195,7 +136,9 @@ template<> bool Print<const void *>(const void *val,
       }
       break;
     case BASE_TYPE_STRING: {
-      if (!EscapeString(*reinterpret_cast<const String *>(val), _text, opts)) {
+      auto str = reinterpret_cast<const String *>(val);
+      if (!EscapeJsonString(str->c_str(), str->size(), opts.allow_non_utf8,
+                            _text)) {
         return false;
       }
       break;
@@ -227,17 +170,28 @@ template<typename T> static bool GenField(const FieldDef &fd,
                                           const Table *table, bool fixed,
                                           const IDLOptions &opts,
                                           int indent,
-                                          std::string *_text) {
+                                          TextSink *_text) {
   return Print(fixed ?
     reinterpret_cast<const Struct *>(table)->GetField<T>(fd.value.offset) :
     table->GetField<T>(fd.value.offset, 0), fd.value.type, indent, nullptr,
                                             opts, _text);
 }
 
+// Generate text for a scalar field that is not present, from its default.
+template<typename T> static bool GenDefault(const FieldDef &fd,
+                                            const IDLOptions &opts,
+                                            TextSink *_text) {
+  auto constant = fd.value.constant.c_str();
+  auto val = IsFloat(fd.value.type.base_type)
+             ? static_cast<T>(StringToDouble(constant))
+             : static_cast<T>(StringToInt(constant));
+  return Print(val, fd.value.type, 0, nullptr, opts, _text);
+}
+
 // Generate text for non-scalar field.
 static bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
                            int indent, StructDef *union_sd,
-                           const IDLOptions &opts, std::string *_text) {
+                           const IDLOptions &opts, TextSink *_text) {
   const void *val = nullptr;
   if (fixed) {
     // The only non-scalar fields in structs are structs.
@@ -256,8 +210,8 @@ static bool GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
 // and bracketed by "{}"
 static bool GenStruct(const StructDef &struct_def, const Table *table,
                       int indent, const IDLOptions &opts,
-                      std::string *_text) {
-  std::string &text = *_text;
+                      TextSink *_text) {
+  TextSink &text = *_text;
   text += "{";
   int fieldout = 0;
   StructDef *union_sd = nullptr;
@@ -274,9 +228,9 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
         text += ",";
       }
       text += NewLine(opts);
-      text.append(indent + Indent(opts), ' ');
+      text.Fill(indent + Indent(opts), ' ');
       OutputIdentifier(fd.name, opts, _text);
-      text += ": ";
+      text += NameSeparator(opts);
       if (is_present) {
         switch (fd.value.type.base_type) {
            #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE, \
@@ -310,22 +264,31 @@ static bool GenStruct(const StructDef &struct_def, const Table *table,
       }
       else
       {
-        text += fd.value.constant;
+        switch (fd.value.type.base_type) {
+           #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE, \
+             PTYPE) \
+             case BASE_TYPE_ ## ENUM: \
+                if (!GenDefault<CTYPE>(fd, opts, _text)) return false; \
+                break;
+            FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD)
+          #undef FLATBUFFERS_TD
+          default:
+            assert(false);  // Only scalars are output when not present.
+        }
       }
     }
   }
   text += NewLine(opts);
-  text.append(indent, ' ');
+  text.Fill(indent, ' ');
   text += "}";
   return true;
 }
 
 // Generate a text representation of a flatbuffer in JSON format.
 bool GenerateText(const Parser &parser, const void *flatbuffer,
-                  std::string *_text) {
-  std::string &text = *_text;
+                  TextSink *_text) {
+  TextSink &text = *_text;
   assert(parser.root_struct_def_);  // call SetRootType()
-  text.reserve(1024);   // Reduce amount of inevitable reallocs.
   if (!GenStruct(*parser.root_struct_def_,
                  GetRoot<Table>(flatbuffer),
                  0,
@@ -337,6 +300,12 @@ bool GenerateText(const Parser &parser, const void *flatbuffer,
   return true;
 }
 
+bool GenerateText(const Parser &parser, const void *flatbuffer,
+                  std::string *_text) {
+  StringTextSink sink(_text);
+  return GenerateText(parser, flatbuffer, &sink);
+}
+
 std::string TextFileName(const std::string &path,
                          const std::string &file_name) {
   return path + file_name + ".json";
@@ -346,13 +315,20 @@ bool GenerateTextFile(const Parser &parser,
                       const std::string &path,
                       const std::string &file_name) {
   if (!parser.builder_.GetSize() || !parser.root_struct_def_) return true;
-  std::string text;
-  if (!GenerateText(parser, parser.builder_.GetBufferPointer(), &text)) {
-    return false;
+  // Written as it is generated, such that large buffers don't need to be
+  // held in memory as text first.
+  auto filename = TextFileName(path, file_name);
+  auto file = fopen(filename.c_str(), "w");
+  if (!file) return false;
+  bool ok;
+  {
+    BufferedTextSink sink(file);
+    ok = GenerateText(parser, parser.builder_.GetBufferPointer(), &sink);
+    ok = sink.Flush() && ok;
   }
-  return flatbuffers::SaveFile(TextFileName(path, file_name).c_str(),
-                               text,
-                               false);
+  ok = fclose(file) == 0 && ok;
+  if (!ok) remove(filename.c_str());  // Don't leave partial text behind.
+  return ok;
 }
 
 std::string TextMakeRule(const Parser &parser,
@@ -26,6 +26,7 @@
 #include <math.h>
 
 #include "flatbuffers/idl.h"
+#include "flatbuffers/json.h"
 #include "flatbuffers/util.h"
 
 namespace flatbuffers {
@@ -61,17 +62,6 @@ static_assert(BASE_TYPE_UNION ==
 #define NEXT() ECHECK(Next())
 #define EXPECT(tok) ECHECK(Expect(tok))
 
-static bool ValidateUTF8(const std::string &str) {
-  const char *s = &str[0];
-  const char * const sEnd = s + str.length();
-  while (s < sEnd) {
-    if (FromUTF8(&s) < 0) {
-      return false;
-    }
-  }
-  return true;
-}
-
 CheckedError Parser::Error(const std::string &msg) {
   error_ = file_being_parsed_.length() ? AbsolutePath(file_being_parsed_) : "";
   #ifdef _WIN32
@@ -101,37 +91,33 @@ CheckedError Parser::CheckBitsFit(int64_t val, size_t bits) {
   return NoError();
 }
 
-// atot: templated version of atoi/atof: convert a string to an instance of T.
-template<typename T> inline CheckedError atot(const char *s, Parser &parser,
-                                              T *val) {
-  int64_t i = StringToInt(s);
-  ECHECK(parser.CheckBitsFit(i, sizeof(T) * 8));
-  *val = (T)i;
-  return NoError();
+// TypedAs: get the binary form of a parsed value (see Value::typed) as the
+// type it is serialized as.
+template<typename T> inline T TypedAs(const Value &val) {
+  return static_cast<T>(val.typed.i);
 }
-template<> inline CheckedError atot<bool>(const char *s, Parser &parser,
-                                          bool *val) {
-  (void)parser;
-  *val = 0 != atoi(s);
-  return NoError();
+template<> inline bool TypedAs<bool>(const Value &val) {
+  return val.typed.i != 0;
 }
-template<> inline CheckedError atot<float>(const char *s, Parser &parser,
-                                           float *val) {
-  (void)parser;
-  *val = static_cast<float>(strtod(s, nullptr));
-  return NoError();
+template<> inline float TypedAs<float>(const Value &val) {
+  return static_cast<float>(val.typed.f);
 }
-template<> inline CheckedError atot<double>(const char *s, Parser &parser,
-                                            double *val) {
-  (void)parser;
-  *val = strtod(s, nullptr);
-  return NoError();
+template<> inline double TypedAs<double>(const Value &val) {
+  return val.typed.f;
+}
+template<> inline Offset<void> TypedAs<Offset<void>>(const Value &val) {
+  return Offset<void>(val.typed.o);
 }
 
-template<> inline CheckedError atot<Offset<void>>(const char *s, Parser &parser,
-                                                  Offset<void> *val) {
-  (void)parser;
-  *val = Offset<void>(atoi(s));
+// Converts the text of a scalar to its binary form, checking that it fits.
+CheckedError Parser::ConstantToTyped(const char *s, Value &e) {
+  if (IsFloat(e.type.base_type)) {
+    e.typed.f = StringToDouble(s);
+  } else {
+    e.typed.i = StringToInt(s);
+    if (e.type.base_type != BASE_TYPE_BOOL)
+      ECHECK(CheckBitsFit(e.typed.i, SizeOf(e.type.base_type) * 8));
+  }
   return NoError();
 }
 
@@ -212,147 +198,81 @@ std::string Parser::TokenToStringId(int t) {
   return TokenToString(t) + (t == kTokenIdentifier ? ": " + attribute_ : "");
 }
 
-// Parses exactly nibbles worth of hex digits into a number, or error.
-CheckedError Parser::ParseHexNum(int nibbles, int64_t *val) {
-  for (int i = 0; i < nibbles; i++)
-    if (!isxdigit(static_cast<const unsigned char>(cursor_[i])))
-      return Error("escape code must be followed by " + NumToString(nibbles) +
-                   " hex digits");
-  std::string target(cursor_, cursor_ + nibbles);
-  *val = StringToUInt(target.c_str(), nullptr, 16);
-  cursor_ += nibbles;
-  return NoError();
-}
-
 CheckedError Parser::SkipByteOrderMark() {
-  if (static_cast<unsigned char>(*cursor_) != 0xef) return NoError();
+  if (static_cast<unsigned char>(Peek()) != 0xef) return NoError();
   cursor_++;
-  if (static_cast<unsigned char>(*cursor_) != 0xbb) return Error("invalid utf-8 byte order mark");
+  if (static_cast<unsigned char>(Peek()) != 0xbb) return Error("invalid utf-8 byte order mark");
   cursor_++;
-  if (static_cast<unsigned char>(*cursor_) != 0xbf) return Error("invalid utf-8 byte order mark");
+  if (static_cast<unsigned char>(Peek()) != 0xbf) return Error("invalid utf-8 byte order mark");
   cursor_++;
   return NoError();
 }
 
-bool IsIdentifierStart(char c) {
-  return isalpha(static_cast<unsigned char>(c)) || c == '_';
-}
-
 CheckedError Parser::Next() {
   doc_comment_.clear();
+  if (replaying_) {
+    if (replay_pos_ >= recorded_tokens_.size())
+      return Error("unexpected end of recorded value");
+    auto &recorded = recorded_tokens_[replay_pos_++];
+    token_ = recorded.token;
+    line_ = recorded.line;
+    cursor_ = recorded.cursor;
+    attribute_ = recorded.attribute;
+    return NoError();
+  }
   bool seen_newline = false;
   attribute_.clear();
   for (;;) {
-    char c = *cursor_++;
+    char c = Peek();
+    cursor_++;
     token_ = c;
     switch (c) {
-      case '\0': cursor_--; token_ = kTokenEof; return NoError();
+      case '\0':
+        cursor_--;
+        if (cursor_ != source_end_)
+          return Error("illegal 0 byte in source, is it a binary file?");
+        token_ = kTokenEof;
+        return NoError();
       case ' ': case '\r': case '\t': break;
       case '\n': line_++; seen_newline = true; break;
       case '{': case '}': case '(': case ')': case '[': case ']':
       case ',': case ':': case ';': case '=': return NoError();
       case '.':
-        if(!isdigit(static_cast<const unsigned char>(*cursor_))) return NoError();
+        if (Peek() < '0' || Peek() > '9') return NoError();
         return Error("floating point constant can\'t start with \".\"");
       case '\"':
       case '\'': {
-        int unicode_high_surrogate = -1;
-
-        while (*cursor_ != c) {
-          if (*cursor_ < ' ' && *cursor_ >= 0)
-            return Error("illegal character in string constant");
-          if (*cursor_ == '\\') {
-            cursor_++;
-            if (unicode_high_surrogate != -1 &&
-                *cursor_ != 'u') {
-              return Error(
-                "illegal Unicode sequence (unpaired high surrogate)");
-            }
-            switch (*cursor_) {
-              case 'n':  attribute_ += '\n'; cursor_++; break;
-              case 't':  attribute_ += '\t'; cursor_++; break;
-              case 'r':  attribute_ += '\r'; cursor_++; break;
-              case 'b':  attribute_ += '\b'; cursor_++; break;
-              case 'f':  attribute_ += '\f'; cursor_++; break;
-              case '\"': attribute_ += '\"'; cursor_++; break;
-              case '\'': attribute_ += '\''; cursor_++; break;
-              case '\\': attribute_ += '\\'; cursor_++; break;
-              case '/':  attribute_ += '/';  cursor_++; break;
-              case 'x': {  // Not in the JSON standard
-                cursor_++;
-                int64_t val;
-                ECHECK(ParseHexNum(2, &val));
-                attribute_ += static_cast<char>(val);
-                break;
-              }
-              case 'u': {
-                cursor_++;
-                int64_t val;
-                ECHECK(ParseHexNum(4, &val));
-                if (val >= 0xD800 && val <= 0xDBFF) {
-                  if (unicode_high_surrogate != -1) {
-                    return Error(
-                      "illegal Unicode sequence (multiple high surrogates)");
-                  } else {
-                    unicode_high_surrogate = static_cast<int>(val);
-                  }
-                } else if (val >= 0xDC00 && val <= 0xDFFF) {
-                  if (unicode_high_surrogate == -1) {
-                    return Error(
-                      "illegal Unicode sequence (unpaired low surrogate)");
-                  } else {
-                    int code_point = 0x10000 +
-                      ((unicode_high_surrogate & 0x03FF) << 10) +
-                      (val & 0x03FF);
-                    ToUTF8(code_point, &attribute_);
-                    unicode_high_surrogate = -1;
-                  }
-                } else {
-                  if (unicode_high_surrogate != -1) {
-                    return Error(
-                      "illegal Unicode sequence (unpaired high surrogate)");
-                  }
-                  ToUTF8(static_cast<int>(val), &attribute_);
-                }
-                break;
-              }
-              default: return Error("unknown escape code in string constant");
-            }
-          } else { // printable chars + UTF-8 bytes
-            if (unicode_high_surrogate != -1) {
-              return Error(
-                "illegal Unicode sequence (unpaired high surrogate)");
-            }
-            attribute_ += *cursor_++;
-          }
-        }
-        if (unicode_high_surrogate != -1) {
-          return Error(
-            "illegal Unicode sequence (unpaired high surrogate)");
-        }
-        cursor_++;
-        if (!opts.allow_non_utf8 && !ValidateUTF8(attribute_)) {
+        // Only strings with non-ASCII characters need UTF-8 validation.
+        bool non_ascii = false;
+        const char *error;
+        auto string_end = json_internal::ScanStringConstant(
+            cursor_, source_end_, c, &attribute_, &non_ascii, &error);
+        if (!string_end) return Error(error);
+        cursor_ = string_end;
+        if (non_ascii && !opts.allow_non_utf8 &&
+            !json_internal::ValidateUTF8(attribute_.c_str(),
+                                         attribute_.length())) {
           return Error("illegal UTF-8 sequence");
         }
         token_ = kTokenStringConstant;
         return NoError();
       }
       case '/':
-        if (*cursor_ == '/') {
+        if (Peek() == '/') {
           const char *start = ++cursor_;
-          while (*cursor_ && *cursor_ != '\n' && *cursor_ != '\r') cursor_++;
-          if (*start == '/') {  // documentation comment
+          while (Peek() && Peek() != '\n' && Peek() != '\r') cursor_++;
+          if (start < source_end_ && *start == '/') {  // doc comment
             if (cursor_ != source_ && !seen_newline)
               return Error(
                     "a documentation comment should be on a line on its own");
             doc_comment_.push_back(std::string(start + 1, cursor_));
           }
           break;
-        } else if (*cursor_ == '*') {
+        } else if (Peek() == '*') {
           cursor_++;
           // TODO: make nested.
-          while (*cursor_ != '*' || cursor_[1] != '/') {
-            if (!*cursor_) return Error("end of file in comment");
+          while (Peek() != '*' || Peek(1) != '/') {
+            if (!Peek()) return Error("end of file in comment");
             cursor_++;
           }
           cursor_ += 2;
@@ -360,12 +280,10 @@ CheckedError Parser::Next() {
         }
         // fall thru
       default:
-        if (IsIdentifierStart(c)) {
+        if (json_internal::IsIdentifierStart(c)) {
           // Collect all chars of an identifier:
           const char *start = cursor_ - 1;
-          while (isalnum(static_cast<unsigned char>(*cursor_)) ||
-                 *cursor_ == '_')
-            cursor_++;
+          while (json_internal::IsIdentifierChar(Peek())) cursor_++;
           attribute_.append(start, cursor_);
           // First, see if it is a type keyword from the table of types:
           #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE, \
@@ -435,46 +353,15 @@ CheckedError Parser::Next() {
           // If not, it is a user-defined identifier:
           token_ = kTokenIdentifier;
           return NoError();
-        } else if (isdigit(static_cast<unsigned char>(c)) || c == '-') {
-          const char *start = cursor_ - 1;
-          if (c == '-' && *cursor_ == '0' && (cursor_[1] == 'x' || cursor_[1] == 'X')) {
-            ++start;
-            ++cursor_;
-            attribute_.append(&c, &c + 1);
-            c = '0';
-          }
-          if (c == '0' && (*cursor_ == 'x' || *cursor_ == 'X')) {
-              cursor_++;
-              while (isxdigit(static_cast<unsigned char>(*cursor_))) cursor_++;
-              attribute_.append(start + 2, cursor_);
-              attribute_ = NumToString(StringToUInt(attribute_.c_str(), nullptr, 16));
-              token_ = kTokenIntegerConstant;
-              return NoError();
-          }
-          while (isdigit(static_cast<unsigned char>(*cursor_))) cursor_++;
-          if (*cursor_ == '.' || *cursor_ == 'e' || *cursor_ == 'E') {
-            if (*cursor_ == '.') {
-              cursor_++;
-              while (isdigit(static_cast<unsigned char>(*cursor_))) cursor_++;
-            }
-            // See if this float has a scientific notation suffix. Both JSON
-            // and C++ (through strtod() we use) have the same format:
-            if (*cursor_ == 'e' || *cursor_ == 'E') {
-              cursor_++;
-              if (*cursor_ == '+' || *cursor_ == '-') cursor_++;
-              while (isdigit(static_cast<unsigned char>(*cursor_))) cursor_++;
-            }
-            token_ = kTokenFloatConstant;
-          } else {
-            token_ = kTokenIntegerConstant;
-          }
-          attribute_.append(start, cursor_);
+        } else if ((c >= '0' && c <= '9') || c == '-') {
+          bool is_float;
+          cursor_ = json_internal::ScanNumberConstant(cursor_ - 1, source_end_,
+                                                      &attribute_, &is_float);
+          token_ = is_float ? kTokenFloatConstant : kTokenIntegerConstant;
           return NoError();
         }
-        std::string ch;
-        ch = c;
-        if (c < ' ' || c > '~') ch = "code: " + NumToString(c);
-        return Error("illegal character: " + ch);
+        return Error("illegal character: " +
+                     json_internal::IllegalCharacter(c));
     }
   }
 }
@@ -506,11 +393,14 @@ CheckedError Parser::ParseNamespacing(std::string *id, std::string *last) {
 }
 
 EnumDef *Parser::LookupEnum(const std::string &id) {
+  // A parser sharing another's schema resolves names in the namespace that
+  // schema ended in, like JSON following the schema in its source would.
+  auto ns = schema_ == this ? namespaces_.back() : schema_->namespaces_.back();
   // Search thru parent namespaces.
-  for (int components = static_cast<int>(namespaces_.back()->components.size());
+  for (int components = static_cast<int>(ns->components.size());
        components >= 0; components--) {
-    auto ed = enums_.Lookup(
-                namespaces_.back()->GetFullyQualifiedName(id, components));
+    auto ed = schema_->enums_.Lookup(
+                ns->GetFullyQualifiedName(id, components));
     if (ed) return ed;
   }
   return nullptr;
@@ -583,6 +473,7 @@ CheckedError Parser::AddField(StructDef &struct_def, const std::string &name,
     field.value.offset = static_cast<voffset_t>(struct_def.bytesize);
     struct_def.bytesize += size;
   }
+  field.index = static_cast<int>(struct_def.fields.vec.size());
   if (struct_def.fields.Add(name, &field))
     return Error("field already exists: " + name);
   *dest = &field;
@@ -621,6 +512,8 @@ CheckedError Parser::ParseField(StructDef &struct_def) {
     if (!strpbrk(field->value.constant.c_str(), ".eE"))
       field->value.constant += ".0";
   }
+  if (IsScalar(type.base_type))
+    ECHECK(ConstantToTyped(field->value.constant.c_str(), field->value));
 
   if (type.enum_def &&
       IsScalar(type.base_type) &&
@@ -711,19 +604,29 @@ CheckedError Parser::ParseAnyValue(Value &val, FieldDef *field,
   switch (val.type.base_type) {
     case BASE_TYPE_UNION: {
       assert(field);
-      std::string constant;
-      if (!parent_fieldn ||
-          field_stack_.back().second->value.type.base_type != BASE_TYPE_UTYPE) {
+      auto type_name = field->name + UnionTypeFieldSuffix();
+      assert(parent_struct_def);
+      auto type_field = parent_struct_def->fields.Lookup(type_name);
+      assert(type_field);  // Guaranteed by ParseField().
+      int64_t type_id = 0;
+      bool has_type = false;
+      size_t start = 0;
+      ParserState after_value;
+      for (auto it = field_stack_.end() - parent_fieldn;
+           it != field_stack_.end(); ++it) {
+        if (it->second == type_field) {
+          type_id = it->first.typed.i;
+          has_type = true;
+        }
+      }
+      if (!has_type) {
         // We haven't seen the type field yet. Sadly a lot of JSON writers
         // output these in alphabetical order, meaning it comes after this
-        // value. So we scan past the value to find it, then come back here.
-        auto type_name = field->name + UnionTypeFieldSuffix();
-        assert(parent_struct_def);
-        auto type_field = parent_struct_def->fields.Lookup(type_name);
-        assert(type_field);  // Guaranteed by ParseField().
-        // Remember where we are in the source file, so we can come back here.
-        auto backup = *static_cast<ParserState *>(this);
-        ECHECK(SkipAnyJsonValue());  // The table.
+        // value. So we record the value as we scan past it to find the type,
+        // then parse it from the recording: no part of the source is scanned
+        // twice, however deeply such unions are nested.
+        ECHECK(RecordJsonValue(&start));
+        after_value = *static_cast<ParserState *>(this);
         EXPECT(',');
         auto next_name = attribute_;
         if (Is(kTokenStringConstant)) {
@@ -737,33 +640,34 @@ CheckedError Parser::ParseAnyValue(Value &val, FieldDef *field,
         EXPECT(':');
         Value type_val = type_field->value;
         ECHECK(ParseAnyValue(type_val, type_field, 0, nullptr));
-        constant = type_val.constant;
-        // Got the information we needed, now rewind:
-        *static_cast<ParserState *>(this) = backup;
-      } else {
-        constant = field_stack_.back().first.constant;
+        type_id = type_val.typed.i;
       }
-      uint8_t enum_idx;
-      ECHECK(atot(constant.c_str(), *this, &enum_idx));
-      auto enum_val = val.type.enum_def->ReverseLookup(enum_idx);
+      auto enum_val = val.type.enum_def->ReverseLookup(
+                                             static_cast<uint8_t>(type_id));
       if (!enum_val) return Error("illegal type id for: " + field->name);
-      ECHECK(ParseTable(*enum_val->struct_def, &val.constant, nullptr));
+      if (!has_type) {
+        replaying_ = true;
+        replay_pos_ = start;
+        NEXT();
+      }
+      ECHECK(ParseTable(*enum_val->struct_def, &val, nullptr));
+      // Continue after the value, where the type field gets parsed again.
+      if (!has_type) *static_cast<ParserState *>(this) = after_value;
       break;
     }
     case BASE_TYPE_STRUCT:
-      ECHECK(ParseTable(*val.type.struct_def, &val.constant, nullptr));
+      ECHECK(ParseTable(*val.type.struct_def, &val, nullptr));
       break;
     case BASE_TYPE_STRING: {
-      auto s = attribute_;
+      // Create the string before moving past its token, to avoid a copy.
+      if (Is(kTokenStringConstant))
+        val.typed.o = builder_.CreateString(attribute_).o;
       EXPECT(kTokenStringConstant);
-      val.constant = NumToString(builder_.CreateString(s).o);
       break;
     }
     case BASE_TYPE_VECTOR: {
       EXPECT('[');
-      uoffset_t off;
-      ECHECK(ParseVector(val.type.VectorType(), &off));
-      val.constant = NumToString(off);
+      ECHECK(ParseVector(val.type.VectorType(), &val.typed.o));
       break;
     }
     case BASE_TYPE_INT:
@@ -774,29 +678,33 @@ CheckedError Parser::ParseAnyValue(Value &val, FieldDef *field,
           (token_ == kTokenIdentifier || token_ == kTokenStringConstant)) {
         ECHECK(ParseHash(val, field));
       } else {
-        ECHECK(ParseSingleValue(val));
+        ECHECK(ParseTypedScalar(val));
       }
       break;
     }
     default:
-      ECHECK(ParseSingleValue(val));
+      ECHECK(ParseTypedScalar(val));
       break;
   }
   return NoError();
 }
 
 void Parser::SerializeStruct(const StructDef &struct_def, const Value &val) {
-  assert(val.constant.length() == struct_def.bytesize);
+  assert(val.typed.s + struct_def.bytesize <= struct_stack_.size());
   builder_.Align(struct_def.minalign);
-  builder_.PushBytes(reinterpret_cast<const uint8_t *>(val.constant.c_str()),
-                     struct_def.bytesize);
+  builder_.PushBytes(struct_stack_.data() + val.typed.s, struct_def.bytesize);
   builder_.AddStructOffset(val.offset, builder_.GetSize());
 }
 
-CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
+CheckedError Parser::ParseTable(const StructDef &struct_def, Value *value,
                                 uoffset_t *ovalue) {
   EXPECT('{');
   size_t fieldn = 0;
+  // Fields usually come in the order they were declared in (that is how
+  // GenerateText() writes them), so try the one after the previous field
+  // before looking the name up.
+  size_t next_field = 0;
+  auto struct_stack_size = struct_stack_.size();
   for (;;) {
     if ((!opts.strict_json || !fieldn) && Is('}')) { NEXT(); break; }
     std::string name = attribute_;
@@ -805,7 +713,11 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
     } else {
       EXPECT(opts.strict_json ? kTokenStringConstant : kTokenIdentifier);
     }
-    auto field = struct_def.fields.Lookup(name);
+    auto &fields = struct_def.fields.vec;
+    auto field = next_field < fields.size() && fields[next_field]->name == name
+                   ? fields[next_field]
+                   : struct_def.fields.Lookup(name);
+    if (field) next_field = static_cast<size_t>(field->index) + 1;
     if (!field) {
       if (!opts.skip_unexpected_fields_in_json) {
         return Error("unknown field: " + name);
@@ -818,7 +730,10 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
       if (Is(kTokenNull)) {
         NEXT(); // Ignore this field.
       } else {
-        Value val = field->value;
+        // Only the type and offset of the field are needed, not its default.
+        Value val;
+        val.type = field->value.type;
+        val.offset = field->value.offset;
         ECHECK(ParseAnyValue(val, field, fieldn, &struct_def));
         size_t i = field_stack_.size();
         // Hardcoded insertion-sort with error-check.
@@ -860,14 +775,11 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
             case BASE_TYPE_ ## ENUM: \
               builder_.Pad(field->padding); \
               if (struct_def.fixed) { \
-                CTYPE val; \
-                ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
-                builder_.PushElement(val); \
+                builder_.PushElement(TypedAs<CTYPE>(field_value)); \
               } else { \
-                CTYPE val, valdef; \
-                ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
-                ECHECK(atot(field->value.constant.c_str(), *this, &valdef)); \
-                builder_.AddElement(field_value.offset, val, valdef); \
+                builder_.AddElement(field_value.offset, \
+                                    TypedAs<CTYPE>(field_value), \
+                                    TypedAs<CTYPE>(field->value)); \
               } \
               break;
             FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD);
@@ -879,9 +791,8 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
               if (IsStruct(field->value.type)) { \
                 SerializeStruct(*field->value.type.struct_def, field_value); \
               } else { \
-                CTYPE val; \
-                ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
-                builder_.AddOffset(field_value.offset, val); \
+                builder_.AddOffset(field_value.offset, \
+                                   TypedAs<CTYPE>(field_value)); \
               } \
               break;
             FLATBUFFERS_GEN_TYPES_POINTER(FLATBUFFERS_TD);
@@ -891,29 +802,33 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
     }
   }
   for (size_t i = 0; i < fieldn; i++) field_stack_.pop_back();
+  // Any structs among the fields have been serialized now.
+  struct_stack_.resize(struct_stack_size);
 
   if (struct_def.fixed) {
     builder_.ClearOffsets();
     builder_.EndStruct();
     assert(value);
-    // Temporarily store this struct in the value string, since it is to
+    // Temporarily store this struct in struct_stack_, since it is to
     // be serialized in-place elsewhere.
-    value->assign(
-          reinterpret_cast<const char *>(builder_.GetCurrentBufferPointer()),
-          struct_def.bytesize);
+    value->typed.s = struct_stack_.size();
+    auto bytes = builder_.GetCurrentBufferPointer();
+    struct_stack_.insert(struct_stack_.end(), bytes,
+                         bytes + struct_def.bytesize);
     builder_.PopBytes(struct_def.bytesize);
     assert(!ovalue);
   } else {
     auto val = builder_.EndTable(start,
                           static_cast<voffset_t>(struct_def.fields.vec.size()));
     if (ovalue) *ovalue = val;
-    if (value) *value = NumToString(val);
+    if (value) value->typed.o = val;
   }
   return NoError();
 }
 
 CheckedError Parser::ParseVector(const Type &type, uoffset_t *ovalue) {
   int count = 0;
+  auto struct_stack_size = struct_stack_.size();
   for (;;) {
     if ((!opts.strict_json || !count) && Is(']')) { NEXT(); break; }
     Value val;
@@ -934,11 +849,7 @@ CheckedError Parser::ParseVector(const Type &type, uoffset_t *ovalue) {
       #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE, PTYPE) \
         case BASE_TYPE_ ## ENUM: \
           if (IsStruct(val.type)) SerializeStruct(*val.type.struct_def, val); \
-          else { \
-             CTYPE elem; \
-             ECHECK(atot(val.constant.c_str(), *this, &elem)); \
-             builder_.PushElement(elem); \
-          } \
+          else builder_.PushElement(TypedAs<CTYPE>(val)); \
           break;
         FLATBUFFERS_GEN_TYPES(FLATBUFFERS_TD)
       #undef FLATBUFFERS_TD
@@ -946,6 +857,8 @@ CheckedError Parser::ParseVector(const Type &type, uoffset_t *ovalue) {
     field_stack_.pop_back();
   }
 
+  struct_stack_.resize(struct_stack_size);
+
   builder_.ClearOffsets();
   *ovalue = builder_.EndVector(count);
   return NoError();
@@ -1041,15 +954,13 @@ CheckedError Parser::ParseHash(Value &e, FieldDef* field) {
     case BASE_TYPE_INT:
     case BASE_TYPE_UINT: {
       auto hash = FindHashFunction32(hash_name->constant.c_str());
-      uint32_t hashed_value = hash(attribute_.c_str());
-      e.constant = NumToString(hashed_value);
+      e.typed.i = hash(attribute_.c_str());
       break;
     }
     case BASE_TYPE_LONG:
     case BASE_TYPE_ULONG: {
       auto hash = FindHashFunction64(hash_name->constant.c_str());
-      uint64_t hashed_value = hash(attribute_.c_str());
-      e.constant = NumToString(hashed_value);
+      e.typed.i = static_cast<int64_t>(hash(attribute_.c_str()));
       break;
     }
     default:
@@ -1061,7 +972,7 @@ CheckedError Parser::ParseHash(Value &e, FieldDef* field) {
 
 CheckedError Parser::ParseSingleValue(Value &e) {
   // First see if this could be a conversion function:
-  if (token_ == kTokenIdentifier && *cursor_ == '(') {
+  if (token_ == kTokenIdentifier && Peek() == '(') {
     auto functionname = attribute_;
     NEXT();
     EXPECT('(');
@@ -1069,7 +980,7 @@ CheckedError Parser::ParseSingleValue(Value &e) {
     EXPECT(')');
     #define FLATBUFFERS_FN_DOUBLE(name, op) \
       if (functionname == name) { \
-        auto x = strtod(e.constant.c_str(), nullptr); \
+        auto x = StringToDouble(e.constant.c_str()); \
         e.constant = NumToString(op); \
       }
     FLATBUFFERS_FN_DOUBLE("deg", x / M_PI * 180);
@@ -1086,7 +997,7 @@ CheckedError Parser::ParseSingleValue(Value &e) {
   } else if (e.type.base_type != BASE_TYPE_STRING &&
       e.type.base_type != BASE_TYPE_NONE &&
       (token_ == kTokenIdentifier || token_ == kTokenStringConstant)) {
-    if (IsIdentifierStart(attribute_[0])) {  // Enum value.
+    if (json_internal::IsIdentifierStart(attribute_[0])) {  // Enum value.
       int64_t val;
       ECHECK(ParseEnumFromString(e.type, &val));
       e.constant = NumToString(val);
@@ -1099,7 +1010,7 @@ CheckedError Parser::ParseSingleValue(Value &e) {
           return Error("invalid integer: " + attribute_);
       } else if (IsFloat(e.type.base_type)) {
         char *end;
-        e.constant = NumToString(strtod(attribute_.c_str(), &end));
+        e.constant = NumToString(StringToDouble(attribute_.c_str(), &end));
         if (*end)
           return Error("invalid float: " + attribute_);
       } else {
@@ -1132,6 +1043,29 @@ CheckedError Parser::ParseSingleValue(Value &e) {
   return NoError();
 }
 
+// Like ParseSingleValue(), but for a scalar in JSON data, which is parsed
+// into Value::typed only. Numbers and enum identifiers, by far the most
+// common, are converted directly. Anything else (numbers in strings,
+// conversion functions) is rare enough to go via ParseSingleValue().
+CheckedError Parser::ParseTypedScalar(Value &e) {
+  if ((token_ == kTokenIntegerConstant && IsScalar(e.type.base_type)) ||
+      (token_ == kTokenFloatConstant && IsFloat(e.type.base_type))) {
+    ECHECK(ConstantToTyped(attribute_.c_str(), e));
+    NEXT();
+  } else if (((token_ == kTokenIdentifier && Peek() != '(') ||
+              token_ == kTokenStringConstant) &&
+             json_internal::IsIdentifierStart(attribute_[0])) {
+    ECHECK(ParseEnumFromString(e.type, &e.typed.i));
+    if (e.type.base_type != BASE_TYPE_BOOL)
+      ECHECK(CheckBitsFit(e.typed.i, SizeOf(e.type.base_type) * 8));
+    NEXT();
+  } else {
+    ECHECK(ParseSingleValue(e));
+    ECHECK(ConstantToTyped(e.constant.c_str(), e));
+  }
+  return NoError();
+}
+
 StructDef *Parser::LookupCreateStruct(const std::string &name,
                                       bool create_if_new, bool definition) {
   std::string qualified_name = namespaces_.back()->GetFullyQualifiedName(name);
@@ -1282,6 +1216,7 @@ CheckedError Parser::ParseEnum(bool is_union, EnumDef **dest) {
       (*it)->value = 1LL << (*it)->value;
     }
   }
+  enum_def.IndexValues();
   if (dest) *dest = &enum_def;
   return NoError();
 }
@@ -1375,6 +1310,7 @@ CheckedError Parser::ParseDecl() {
           return Error("field id\'s must be consecutive from 0, id " +
                 NumToString(i) + " missing or set twice");
         fields[i]->value.offset = FieldIndexToOffset(static_cast<voffset_t>(i));
+        fields[i]->index = i;
       }
     }
   }
@@ -1431,10 +1367,11 @@ CheckedError Parser::ParseService() {
 }
 
 bool Parser::SetRootType(const char *name) {
-  root_struct_def_ = structs_.Lookup(name);
+  auto &schema = *schema_;
+  root_struct_def_ = schema.structs_.Lookup(name);
   if (!root_struct_def_)
-    root_struct_def_ = structs_.Lookup(
-                         namespaces_.back()->GetFullyQualifiedName(name));
+    root_struct_def_ = schema.structs_.Lookup(
+                         schema.namespaces_.back()->GetFullyQualifiedName(name));
   return root_struct_def_ != nullptr;
 }
 
@@ -1532,6 +1469,7 @@ CheckedError Parser::ParseProtoDecl() {
       if (it != v.begin() && it[0]->value == it[-1]->value) it = v.erase(it);
       else ++it;
     }
+    enum_def->IndexValues();
   } else if (attribute_ == "syntax") {  // Skip these.
     NEXT();
     EXPECT('=');
@@ -1650,8 +1588,10 @@ CheckedError Parser::ParseProtoFields(StructDef *struct_def, bool isextend,
           if (key == "default") {
             // Temp: skip non-numeric defaults (enums).
             auto numeric = strpbrk(val.c_str(), "0123456789-+.");
-            if (IsScalar(type.base_type) && numeric == val.c_str())
+            if (IsScalar(type.base_type) && numeric == val.c_str()) {
               field->value.constant = val;
+              ECHECK(ConstantToTyped(val.c_str(), field->value));
+            }
           } else if (key == "deprecated") {
             field->deprecated = val == "true";
           }
@@ -1804,13 +1744,115 @@ CheckedError Parser::SkipJsonString() {
   return NoError();
 }
 
+// Scans past the value that starts at the current token, keeping its tokens
+// (and the one after it) in recorded_tokens_ from index *start, such that it
+// can be parsed later without scanning it again. Values that were recorded
+// already are not copied again: replaying them just jumps past them.
+CheckedError Parser::RecordJsonValue(size_t *start) {
+  if (replaying_) {
+    *start = replay_pos_ - 1;
+    replay_pos_ = recorded_tokens_[*start].end;
+    return Next();
+  }
+  recorded_tokens_.clear();
+  *start = 0;
+  std::vector<size_t> open;
+  for (;;) {
+    auto index = recorded_tokens_.size();
+    recorded_tokens_.push_back(RecordedToken(token_, line_, cursor_,
+                                             attribute_, index + 1));
+    if (Is('{') || Is('[')) {
+      open.push_back(index);
+    } else if ((Is('}') || Is(']')) && !open.empty()) {
+      recorded_tokens_[open.back()].end = index + 1;
+      open.pop_back();
+    }
+    // Syntax errors are left for when the value is parsed.
+    if (open.empty() || Is(kTokenEof)) break;
+    NEXT();
+  }
+  NEXT();
+  recorded_tokens_.push_back(RecordedToken(token_, line_, cursor_, attribute_,
+                                           recorded_tokens_.size() + 1));
+  return NoError();
+}
+
 bool Parser::Parse(const char *source, const char **include_paths,
                    const char *source_filename) {
-  return !DoParse(source, include_paths, source_filename).Check();
+  return ParseBuffer(source, strlen(source), include_paths, source_filename);
+}
+
+bool Parser::ParseBuffer(const char *source, size_t length,
+                         const char **include_paths,
+                         const char *source_filename) {
+  return !DoParse(source, length, include_paths, source_filename).Check();
+}
+
+// Parses a JSON object of the root type into builder_, and finishes it.
+CheckedError Parser::ParseRootTable(bool size_prefixed) {
+  uoffset_t toff;
+  ECHECK(ParseTable(*root_struct_def_, nullptr, &toff));
+  auto file_identifier = file_identifier_.length() ? file_identifier_.c_str()
+                                                   : nullptr;
+  if (size_prefixed)
+    builder_.FinishSizePrefixed(Offset<Table>(toff), file_identifier);
+  else
+    builder_.Finish(Offset<Table>(toff), file_identifier);
+  return NoError();
+}
+
+bool Parser::ParseJsonStream(const char *source, size_t length,
+                             const JsonObjectCallback &callback,
+                             bool size_prefixed) {
+  return !DoParseJsonStream(source, length, callback, size_prefixed).Check();
 }
 
-CheckedError Parser::DoParse(const char *source, const char **include_paths,
+// Unlike DoParse(), this does no per-file setup beyond resetting the cursor,
+// since it may be called for every object in a stream.
+CheckedError Parser::StartJson(const char *source, size_t length) {
+  source_ = cursor_ = source;
+  source_end_ = source + length;
+  line_ = 1;
+  replaying_ = false;
+  error_.clear();
+  if (!root_struct_def_)
+    return Error("no root type set to parse json with");
+  ECHECK(SkipByteOrderMark());
+  return Next();
+}
+
+CheckedError Parser::DoParseJsonStream(const char *source, size_t length,
+                                       const JsonObjectCallback &callback,
+                                       bool size_prefixed) {
+  file_being_parsed_.clear();
+  ECHECK(StartJson(source, length));
+  while (token_ != kTokenEof) {
+    builder_.Clear();
+    ECHECK(ParseRootTable(size_prefixed));
+    if (!callback(builder_)) return Error("stopped by json object callback");
+  }
+  return NoError();
+}
+
+// Parse() for parsers that share the schema of another, which must not
+// change it: the source can only be a single JSON object.
+CheckedError Parser::DoParseJson(const char *source, size_t length,
+                                 const char *source_filename) {
+  file_being_parsed_ = source_filename ? source_filename : "";
+  builder_.Clear();
+  ECHECK(StartJson(source, length));
+  if (token_ != '{')
+    return Error("a parser that shares a schema can only parse json");
+  ECHECK(ParseRootTable(false));
+  if (token_ != kTokenEof)
+    return Error("cannot have more than one json object in a file");
+  return NoError();
+}
+
+CheckedError Parser::DoParse(const char *source, size_t length,
+                             const char **include_paths,
                              const char *source_filename) {
+  if (schema_ != this) return DoParseJson(source, length, source_filename);
   file_being_parsed_ = source_filename ? source_filename : "";
   if (source_filename &&
       included_files_.find(source_filename) == included_files_.end()) {
@@ -1822,7 +1864,9 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
     include_paths = current_directory;
   }
   source_ = cursor_ = source;
+  source_end_ = source + length;
   line_ = 1;
+  replaying_ = false;
   error_.clear();
   builder_.Clear();
   // Start with a blank namespace just in case this file doesn't have one.
@@ -1848,7 +1892,10 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
       std::string filepath;
       for (auto paths = include_paths; paths && *paths; paths++) {
         filepath = flatbuffers::ConCatPathFileName(*paths, name);
-        if(FileExists(filepath.c_str())) break;
+        // Files we've parsed before exist, no need to ask the file system.
+        if (included_files_.find(filepath) != included_files_.end() ||
+            FileExists(filepath.c_str()))
+          break;
       }
       if (filepath.empty())
         return Error("unable to locate include file: " + name);
@@ -1860,17 +1907,25 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
         std::string contents;
         if (!LoadFile(filepath.c_str(), true, &contents))
           return Error("unable to load include file: " + name);
-        ECHECK(DoParse(contents.c_str(), include_paths, filepath.c_str()));
+        // Then continue this file where we left off, such that every file
+        // is only parsed once, however many includes it has.
+        ParserState state = *this;
+        auto file_namespace = namespaces_.back();
+        auto file_source = source_;
+        auto file_source_end = source_end_;
+        auto file_being_parsed = file_being_parsed_;
+        ECHECK(DoParse(contents.c_str(), contents.length(), include_paths,
+                       filepath.c_str()));
         // We generally do not want to output code for any included files:
         if (!opts.generate_all) MarkGenerated();
-        // This is the easiest way to continue this file after an include:
-        // instead of saving and restoring all the state, we simply start the
-        // file anew. This will cause it to encounter the same include
-        // statement again, but this time it will skip it, because it was
-        // entered into included_files_.
-        // This is recursive, but only go as deep as the number of include
-        // statements.
-        return DoParse(source, include_paths, source_filename);
+        *static_cast<ParserState *>(this) = state;
+        source_ = file_source;
+        source_end_ = file_source_end;
+        file_being_parsed_ = file_being_parsed;
+        // The included file may have declared a namespace, so make the one
+        // this file had current again.
+        *std::remove(namespaces_.begin(), namespaces_.end(), file_namespace) =
+          file_namespace;
       }
       EXPECT(';');
     } else {
@@ -1889,10 +1944,7 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
       if (builder_.GetSize()) {
         return Error("cannot have more than one json object in a file");
       }
-      uoffset_t toff;
-      ECHECK(ParseTable(*root_struct_def_, nullptr, &toff));
-      builder_.Finish(Offset<Table>(toff),
-                file_identifier_.length() ? file_identifier_.c_str() : nullptr);
+      ECHECK(ParseRootTable(false));
     } else if (token_ == kTokenEnum) {
       ECHECK(ParseEnum(false, nullptr));
     } else if (token_ == kTokenUnion) {
@@ -1956,6 +2008,123 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
   return NoError();
 }
 
+bool ChunkedJsonParser::Feed(const char *chunk, size_t length) {
+  buffer_.append(chunk, length);
+  for (;;) {
+    bool complete;
+    if (!ScanObject(&complete)) return false;
+    if (!complete) break;
+    auto object = buffer_.c_str() + object_start_;
+    auto object_length = scanned_ - object_start_;
+    if (callback_) {
+      if (!parser_.ParseJsonStream(object, object_length, callback_,
+                                   size_prefixed_))
+        return false;
+    } else if (!parser_.ParseBuffer(object, object_length)) {
+      return false;
+    }
+    done_ = true;
+    // Go on scanning for the next object (or, if we want just one, to check
+    // there's nothing but whitespace and comments after it).
+  }
+  // Only keep the part of the current object we've seen so far. Between
+  // objects, there is nothing worth keeping.
+  auto keep_from = depth_ ? object_start_ : scanned_;
+  buffer_.erase(0, keep_from);
+  object_start_ -= std::min(object_start_, keep_from);
+  scanned_ -= keep_from;
+  return true;
+}
+
+bool ChunkedJsonParser::Finish() {
+  if (depth_) return Error("unexpected end of json object");
+  if (!done_ && !callback_) return Error("no json object");
+  return true;
+}
+
+bool ChunkedJsonParser::ScanObject(bool *complete) {
+  *complete = false;
+  auto start = buffer_.c_str();
+  auto end = start + buffer_.size();
+  auto p = start + scanned_;
+  while (p < end) {
+    auto c = *p++;
+    switch (comment_) {
+      case kNoComment:
+        break;
+      case kCommentStart:
+        if (c == '/') {
+          comment_ = kLineComment;
+        } else if (c == '*') {
+          comment_ = kBlockComment;
+        } else {
+          // Not a comment after all, leave it to the parser to complain.
+          if (!depth_) return Error("expecting a json object, found: /");
+          comment_ = kNoComment;
+          p--;
+        }
+        continue;
+      case kLineComment:
+        if (c == '\n' || c == '\r') comment_ = kNoComment;
+        continue;
+      case kBlockComment:
+        if (c == '*') comment_ = kBlockCommentEnd;
+        continue;
+      case kBlockCommentEnd:
+        if (c == '/') comment_ = kNoComment;
+        else if (c != '*') comment_ = kBlockComment;
+        continue;
+    }
+    if (quote_) {
+      if (escape_) {
+        escape_ = false;
+      } else if (c == '\\') {
+        escape_ = true;
+      } else if (c == quote_) {
+        quote_ = 0;
+      } else {
+        bool non_ascii = false;
+        p = json_internal::ScanStringChars(p, end, quote_, &non_ascii);
+      }
+      continue;
+    }
+    switch (c) {
+      case ' ': case '\t': case '\r': case '\n':
+        break;
+      case '/':
+        comment_ = kCommentStart;
+        break;
+      case '{':
+        if (!depth_ && done_ && !callback_)
+          return Error("cannot have more than one json object in a file");
+        if (!depth_) object_start_ = p - 1 - start;
+        depth_++;
+        break;
+      case '}': case ']':
+        if (!depth_) return Error(std::string("unexpected: ") + c);
+        if (!--depth_) {
+          scanned_ = p - start;
+          *complete = true;
+          return true;
+        }
+        break;
+      default:
+        if (!depth_)
+          return Error(std::string("expecting a json object, found: ") + c);
+        if (c == '\"' || c == '\'') quote_ = c;
+        if (c == '[') depth_++;
+        break;
+    }
+  }
+  scanned_ = p - start;
+  return true;
+}
+
+bool ChunkedJsonParser::Error(const std::string &msg) {
+  parser_.error_ = msg;
+  return false;
+}
+
 std::set<std::string> Parser::GetIncludedFilesRecursive(
     const std::string &file_name) const {
   std::set<std::string> included_files;
@@ -2052,7 +2221,7 @@ Offset<reflection::Field> FieldDef::Serialize(FlatBufferBuilder *builder,
                                    ? StringToInt(value.constant.c_str())
                                    : 0,
                                  IsFloat(value.type.base_type)
-                                   ? strtod(value.constant.c_str(), nullptr)
+                                   ? StringToDouble(value.constant.c_str())
                                    : 0.0,
                                  deprecated,
                                  required,
@@ -2100,10 +2269,13 @@ flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<
     Definition::SerializeAttributes(FlatBufferBuilder *builder,
                                     const Parser &parser) const {
   std::vector<flatbuffers::Offset<reflection::KeyValue>> attrs;
-  for (auto kv = attributes.dict.begin(); kv != attributes.dict.end(); ++kv) {
+  // The dictionary is unordered, sort it so the output is deterministic.
+  std::map<std::string, Value *> sorted(attributes.dict.begin(),
+                                        attributes.dict.end());
+  for (auto kv = sorted.begin(); kv != sorted.end(); ++kv) {
     auto it = parser.known_attributes_.find(kv->first);
     assert(it != parser.known_attributes_.end());
-    if (!it->second) {  // Custom attribute.
+    if (!it->second || parser.opts.binary_schema_builtins) {
       attrs.push_back(
           reflection::CreateKeyValue(*builder, builder->CreateString(kv->first),
                                      builder->CreateString(
@@ -2117,6 +2289,227 @@ flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<
   }
 }
 
+bool Parser::Deserialize(const uint8_t *buf) {
+  if (!reflection::SchemaBufferHasIdentifier(buf)) {
+    error_ = "not a binary schema";
+    return false;
+  }
+  if (structs_.vec.size() || enums_.vec.size()) {
+    error_ = "binary schemas can only be loaded into an empty parser";
+    return false;
+  }
+  auto schema = reflection::GetSchema(buf);
+  bool ok = true;
+  // Create all definitions first, since types refer to them by index.
+  // A duplicate name makes the schema inconsistent: don't create a
+  // definition for it at all.
+  for (auto it = schema->objects()->begin();
+       ok && it != schema->objects()->end(); ++it) {
+    if (structs_.Lookup(it->name()->str())) {
+      ok = false;
+      break;
+    }
+    auto struct_def = new StructDef();
+    struct_def->defined_namespace =
+      LookupCreateNamespace(it->name()->str(), &struct_def->name);
+    structs_.Add(it->name()->str(), struct_def);
+  }
+  for (auto it = schema->enums()->begin(); ok && it != schema->enums()->end();
+       ++it) {
+    if (enums_.Lookup(it->name()->str())) {
+      ok = false;
+      break;
+    }
+    auto enum_def = new EnumDef();
+    enum_def->defined_namespace =
+      LookupCreateNamespace(it->name()->str(), &enum_def->name);
+    enums_.Add(it->name()->str(), enum_def);
+  }
+  for (uoffset_t i = 0; i < schema->objects()->size(); i++) {
+    ok = ok && structs_.vec[i]->Deserialize(*this, schema->objects()->Get(i));
+  }
+  for (uoffset_t i = 0; i < schema->enums()->size(); i++) {
+    ok = ok && enums_.vec[i]->Deserialize(*this, schema->enums()->Get(i));
+  }
+  // Struct fields are followed by padding up to the next field, which needs
+  // the sizes of all structs to be known.
+  for (auto it = structs_.vec.begin(); ok && it != structs_.vec.end(); ++it) {
+    auto &struct_def = **it;
+    if (!struct_def.fixed) continue;
+    auto &fields = struct_def.fields.vec;
+    for (size_t i = 0; i < fields.size(); i++) {
+      auto end = fields[i]->value.offset + InlineSize(fields[i]->value.type);
+      auto next = i + 1 < fields.size() ? fields[i + 1]->value.offset
+                                        : struct_def.bytesize;
+      ok = ok && next >= end;
+      fields[i]->padding = next - end;
+    }
+  }
+  if (ok && schema->root_table()) {
+    root_struct_def_ = structs_.Lookup(schema->root_table()->name()->str());
+    if (root_struct_def_) {
+      // Unqualified names resolve in the namespace of the root type, as they
+      // do after parsing the schema source.
+      auto ns = root_struct_def_->defined_namespace;
+      *std::remove(namespaces_.begin(), namespaces_.end(), ns) = ns;
+    } else {
+      ok = false;  // The root table is not among the objects.
+    }
+  }
+  if (!ok) {
+    error_ = "binary schema is inconsistent";
+    return false;
+  }
+  file_identifier_ = schema->file_ident() ? schema->file_ident()->str() : "";
+  file_extension_ = schema->file_ext() ? schema->file_ext()->str() : "";
+  return true;
+}
+
+// Splits a fully qualified name from a binary schema into its namespace
+// (shared by all definitions in it) and its unqualified name.
+Namespace *Parser::LookupCreateNamespace(const std::string &qualified_name,
+                                         std::string *name) {
+  std::vector<std::string> components;
+  size_t start = 0;
+  for (;;) {
+    auto dot = qualified_name.find('.', start);
+    if (dot == std::string::npos) break;
+    components.push_back(qualified_name.substr(start, dot - start));
+    start = dot + 1;
+  }
+  *name = qualified_name.substr(start);
+  for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
+    if ((*it)->components == components) return *it;
+  }
+  auto ns = new Namespace();
+  ns->components = components;
+  namespaces_.push_back(ns);
+  return ns;
+}
+
+bool StructDef::Deserialize(Parser &parser, const reflection::Object *object) {
+  fixed = object->is_struct();
+  predecl = false;
+  minalign = static_cast<size_t>(object->minalign());
+  bytesize = static_cast<size_t>(object->bytesize());
+  if (!DeserializeAttributes(parser, object->attributes())) return false;
+  sortbysize = attributes.Lookup("original_order") == nullptr && !fixed;
+  // Fields are sorted by name, put them back in the order they were declared.
+  auto num_fields = object->fields()->size();
+  std::vector<const reflection::Field *> by_id(num_fields, nullptr);
+  for (auto it = object->fields()->begin(); it != object->fields()->end();
+       ++it) {
+    if (it->id() >= num_fields || by_id[it->id()]) return false;
+    by_id[it->id()] = *it;
+  }
+  for (auto it = by_id.begin(); it != by_id.end(); ++it) {
+    auto field_def = new FieldDef();
+    field_def->index = static_cast<int>(fields.vec.size());
+    if (fields.Add((*it)->name()->str(), field_def) ||
+        !field_def->Deserialize(parser, *it))
+      return false;
+    if (field_def->key) has_key = true;
+  }
+  return true;
+}
+
+bool FieldDef::Deserialize(Parser &parser, const reflection::Field *field) {
+  name = field->name()->str();
+  if (!value.type.Deserialize(parser, field->type())) return false;
+  value.offset = field->offset();
+  if (IsInteger(value.type.base_type)) {
+    value.constant = NumToString(field->default_integer());
+    value.typed.i = field->default_integer();
+  } else if (IsFloat(value.type.base_type)) {
+    value.constant = NumToString(field->default_real());
+    value.typed.f = field->default_real();
+  }
+  deprecated = field->deprecated();
+  required = field->required();
+  key = field->key();
+  return DeserializeAttributes(parser, field->attributes());
+}
+
+bool EnumDef::Deserialize(Parser &parser, const reflection::Enum *_enum) {
+  is_union = _enum->is_union();
+  if (!underlying_type.Deserialize(parser, _enum->underlying_type()))
+    return false;
+  for (auto it = _enum->values()->begin(); it != _enum->values()->end();
+       ++it) {
+    auto enum_val = new EnumVal(it->name()->str(), it->value());
+    if (vals.Add(enum_val->name, enum_val) ||
+        !enum_val->Deserialize(parser, *it))
+      return false;
+  }
+  IndexValues();
+  return DeserializeAttributes(parser, _enum->attributes());
+}
+
+void EnumDef::IndexValues() {
+  dense_vals_.clear();
+  if (vals.vec.empty()) return;
+  auto min = vals.vec.front()->value;
+  auto max = min;
+  for (auto it = vals.vec.begin(); it != vals.vec.end(); ++it) {
+    min = std::min(min, (*it)->value);
+    max = std::max(max, (*it)->value);
+  }
+  // Only worth it if the table is not much larger than the values it holds,
+  // e.g. not for bit_flags with many bits.
+  auto range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+  if (range >= std::max<uint64_t>(256, 4 * vals.vec.size())) return;
+  dense_min_ = min;
+  dense_vals_.resize(static_cast<size_t>(range) + 1, nullptr);
+  // Like the linear search, return the first value declared.
+  for (auto it = vals.vec.rbegin(); it != vals.vec.rend(); ++it) {
+    dense_vals_[static_cast<size_t>(static_cast<uint64_t>((*it)->value) -
+                                    static_cast<uint64_t>(min))] = *it;
+  }
+}
+
+bool EnumVal::Deserialize(const Parser &parser,
+                          const reflection::EnumVal *val) {
+  if (!val->object()) return true;
+  struct_def = parser.structs_.Lookup(val->object()->name()->str());
+  return struct_def != nullptr;
+}
+
+bool Type::Deserialize(const Parser &parser, const reflection::Type *type) {
+  base_type = static_cast<BaseType>(type->base_type());
+  element = static_cast<BaseType>(type->element());
+  if (type->base_type() > reflection::Union ||
+      type->element() > reflection::Union)
+    return false;
+  auto index = type->index();
+  if (base_type == BASE_TYPE_STRUCT ||
+      (base_type == BASE_TYPE_VECTOR && element == BASE_TYPE_STRUCT)) {
+    if (index < 0 || static_cast<size_t>(index) >= parser.structs_.vec.size())
+      return false;
+    struct_def = parser.structs_.vec[index];
+  } else if (index >= 0) {
+    if (static_cast<size_t>(index) >= parser.enums_.vec.size()) return false;
+    enum_def = parser.enums_.vec[index];
+  } else if (base_type == BASE_TYPE_UNION || base_type == BASE_TYPE_UTYPE) {
+    return false;
+  }
+  return true;
+}
+
+bool Definition::DeserializeAttributes(
+    Parser &parser, const Vector<Offset<reflection::KeyValue>> *attrs) {
+  if (!attrs) return true;
+  for (auto it = attrs->begin(); it != attrs->end(); ++it) {
+    auto value = new Value();
+    if (it->value()) value->constant = it->value()->str();
+    if (attributes.Add(it->key()->str(), value)) return false;
+    // Attributes the parser doesn't know are custom ones.
+    if (parser.known_attributes_.find(it->key()->str()) ==
+        parser.known_attributes_.end())
+      parser.known_attributes_[it->key()->str()] = false;
+  }
+  return true;
+}
+
 std::string Parser::ConformTo(const Parser &base) {
   for (auto sit = structs_.vec.begin(); sit != structs_.vec.end(); ++sit) {
     auto &struct_def = **sit;
@@ -2131,7 +2524,15 @@ std::string Parser::ConformTo(const Parser &base) {
       if (field_base) {
         if (field.value.offset != field_base->value.offset)
           return "offsets differ for field: " + field.name;
-        if (field.value.constant != field_base->value.constant)
+        // Compare scalar defaults by value, their text may be formatted
+        // differently (e.g. if one schema was loaded from binary).
+        auto &value = field.value;
+        auto &value_base = field_base->value;
+        if (IsFloat(value.type.base_type)
+              ? value.typed.f != value_base.typed.f
+              : IsScalar(value.type.base_type)
+                  ? value.typed.i != value_base.typed.i
+                  : value.constant != value_base.constant)
           return "defaults differ for field: " + field.name;
         if (!EqualByName(field.value.type, field_base->value.type))
           return "types differ for field: " + field.name;
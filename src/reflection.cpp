@@ -53,7 +53,7 @@ double GetAnyValueF(reflection::BaseType type, const uint8_t *data) {
     case reflection::String: {
       auto s = reinterpret_cast<const String *>(ReadScalar<uoffset_t>(data) +
                                                 data);
-      return s ? strtod(s->c_str(), nullptr) : 0.0;
+      return s ? StringToDouble(s->c_str()) : 0.0;
     }
     default: return static_cast<double>(GetAnyValueI(type, data));
   }
@@ -63,6 +63,7 @@ std::string GetAnyValueS(reflection::BaseType type, const uint8_t *data,
                          const reflection::Schema *schema, int type_index) {
   switch (type) {
     case reflection::Float:
+      return NumToString(static_cast<float>(GetAnyValueF(type, data)));
     case reflection::Double: return NumToString(GetAnyValueF(type, data));
     case reflection::String: {
       auto s = reinterpret_cast<const String *>(ReadScalar<uoffset_t>(data) +
@@ -142,7 +143,7 @@ void SetAnyValueS(reflection::BaseType type, uint8_t *data, const char *val) {
   switch (type) {
     case reflection::Float:
     case reflection::Double:
-      SetAnyValueF(type, data, strtod(val, nullptr));
+      SetAnyValueF(type, data, StringToDouble(val));
       break;
     // TODO: support strings.
     default: SetAnyValueI(type, data, StringToInt(val)); break;
@@ -333,6 +334,228 @@ uint8_t *ResizeAnyVector(const reflection::Schema &schema, uoffset_t newsize,
   return flatbuf->data() + start;
 }
 
+// Changes all offsets in a FlatBuffer to what they will be once the bytes of
+// a ResizeTransaction have been inserted and removed, visiting each table and
+// vector of offsets once.
+class FixupContext {
+ public:
+  // "starts" are the sorted insertion points of the resizes, and "shifts"
+  // how far the bytes from each onwards move (one more than "starts", the
+  // first being 0).
+  FixupContext(const reflection::Schema &schema, std::vector<uint8_t> &buf,
+               const std::vector<uoffset_t> &starts,
+               const std::vector<int> &shifts,
+               const reflection::Object &root_table)
+     : schema_(schema), buf_(buf), starts_(starts), shifts_(shifts),
+       visited_(buf.size() / sizeof(uoffset_t), false) {
+    auto root = GetAnyRoot(buf_.data());
+    Fixup<uoffset_t>(buf_.data(), reinterpret_cast<uint8_t *>(root),
+                     buf_.data());
+    FixupTable(root_table, root);
+  }
+
+  // Where a byte of the buffer ends up. Nothing points into removed bytes.
+  uoffset_t Map(const uint8_t *p) const {
+    auto pos = static_cast<uoffset_t>(p - buf_.data());
+    auto it = std::upper_bound(starts_.begin(), starts_.end(), pos);
+    return static_cast<uoffset_t>(pos + shifts_[it - starts_.begin()]);
+  }
+
+ private:
+  // Sets the offset at offsetloc (of type T) to the distance between first
+  // and second once moved.
+  template<typename T> void Fixup(const uint8_t *first, const uint8_t *second,
+                                  uint8_t *offsetloc) {
+    WriteScalar<T>(offsetloc, static_cast<T>(Map(second) - Map(first)));
+  }
+
+  // Returns if the table or vector at p was visited before, since its offsets
+  // have been changed already and can't be read anymore.
+  bool Visit(const void *p) {
+    auto idx = reinterpret_cast<const uoffset_t *>(p) -
+               reinterpret_cast<const uoffset_t *>(buf_.data());
+    if (visited_[idx]) return true;
+    visited_[idx] = true;
+    return false;
+  }
+
+  void FixupTable(const reflection::Object &objectdef, Table *table) {
+    if (Visit(table)) return;
+    auto tableloc = reinterpret_cast<uint8_t *>(table);
+    auto vtable = table->GetVTable();
+    // Everything a table refers to is stored after it, so past the last
+    // insertion point all of it moves by the same amount.
+    if (tableloc < buf_.data() + starts_.back()) {
+      auto fielddefs = objectdef.fields();
+      for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+        auto &fielddef = **it;
+        auto base_type = fielddef.type()->base_type();
+        // Ignore scalars.
+        if (base_type <= reflection::Double) continue;
+        // Ignore fields that are not stored.
+        auto offset = table->GetOptionalFieldOffset(fielddef.offset());
+        if (!offset) continue;
+        // Ignore structs.
+        auto subobjectdef = base_type == reflection::Obj ?
+          schema_.objects()->Get(fielddef.type()->index()) : nullptr;
+        if (subobjectdef && subobjectdef->is_struct()) continue;
+        auto offsetloc = tableloc + offset;
+        auto ref = offsetloc + ReadScalar<uoffset_t>(offsetloc);
+        Fixup<uoffset_t>(offsetloc, ref, offsetloc);
+        // Recurse.
+        switch (base_type) {
+          case reflection::Obj: {
+            FixupTable(*subobjectdef, reinterpret_cast<Table *>(ref));
+            break;
+          }
+          case reflection::Vector: {
+            auto elem_type = fielddef.type()->element();
+            if (elem_type != reflection::Obj && elem_type != reflection::String)
+              break;
+            auto elemobjectdef = elem_type == reflection::Obj
+              ? schema_.objects()->Get(fielddef.type()->index())
+              : nullptr;
+            if (elemobjectdef && elemobjectdef->is_struct()) break;
+            if (Visit(ref)) break;
+            auto vec = reinterpret_cast<Vector<uoffset_t> *>(ref);
+            for (uoffset_t i = 0; i < vec->size(); i++) {
+              auto loc = vec->Data() + i * sizeof(uoffset_t);
+              auto dest = loc + vec->Get(i);
+              Fixup<uoffset_t>(loc, dest, loc);
+              if (elemobjectdef)
+                FixupTable(*elemobjectdef, reinterpret_cast<Table *>(dest));
+            }
+            break;
+          }
+          case reflection::Union: {
+            FixupTable(GetUnionType(schema_, objectdef, fielddef, *table),
+                       reinterpret_cast<Table *>(ref));
+            break;
+          }
+          case reflection::String:
+            break;
+          default:
+            assert(false);
+        }
+      }
+    }
+    // Must do this last, since GetOptionalFieldOffset above still reads
+    // this value.
+    Fixup<soffset_t>(vtable, tableloc, tableloc);
+  }
+
+  FixupContext &operator=(const FixupContext &);
+
+  const reflection::Schema &schema_;
+  std::vector<uint8_t> &buf_;
+  const std::vector<uoffset_t> &starts_;
+  const std::vector<int> &shifts_;
+  std::vector<bool> visited_;
+};
+
+// Rounds up to a multiple of the largest alignment, like ResizeContext, such
+// that everything following stays aligned.
+static int AlignDelta(int delta) {
+  auto mask = static_cast<int>(sizeof(largest_scalar_t) - 1);
+  return (delta + mask) & ~mask;
+}
+
+void ResizeTransaction::SetString(const std::string &val, const String *str) {
+  Resize resize;
+  resize.object = static_cast<uoffset_t>(
+                    reinterpret_cast<const uint8_t *>(str) - buf_.data());
+  resize.start = resize.object + static_cast<uoffset_t>(sizeof(uoffset_t));
+  resize.old_size = str->Length();
+  resize.new_size = static_cast<uoffset_t>(val.size());
+  resize.delta = AlignDelta(static_cast<int>(resize.new_size) -
+                            static_cast<int>(resize.old_size));
+  resize.elem_size = 0;
+  resize.data = val;
+  resizes_.push_back(resize);
+}
+
+void ResizeTransaction::ResizeAnyVector(uoffset_t newsize,
+                                        const VectorOfAny *vec,
+                                        uoffset_t num_elems,
+                                        uoffset_t elem_size,
+                                        const uint8_t *val) {
+  if (newsize == num_elems) return;
+  Resize resize;
+  resize.object = static_cast<uoffset_t>(
+                    reinterpret_cast<const uint8_t *>(vec) - buf_.data());
+  resize.old_size = num_elems;
+  resize.new_size = newsize;
+  resize.elem_size = elem_size;
+  resize.delta = AlignDelta((static_cast<int>(newsize) -
+                             static_cast<int>(num_elems)) *
+                            static_cast<int>(elem_size));
+  // Bytes are added after the last element, or taken from the elements
+  // being removed.
+  resize.start = resize.object + static_cast<uoffset_t>(sizeof(uoffset_t)) +
+                 elem_size * num_elems;
+  if (resize.delta < 0) resize.start += resize.delta;
+  if (val) resize.data.assign(reinterpret_cast<const char *>(val), elem_size);
+  resizes_.push_back(resize);
+}
+
+void ResizeTransaction::Commit() {
+  if (resizes_.empty()) return;
+  std::sort(resizes_.begin(), resizes_.end());
+  std::vector<uoffset_t> starts;
+  std::vector<int> shifts(1, 0);
+  for (auto it = resizes_.begin(); it != resizes_.end(); ++it) {
+    starts.push_back(it->start);
+    shifts.push_back(shifts.back() + it->delta);
+  }
+  // Change the offsets first, while the buffer is still in one piece.
+  std::vector<uoffset_t> objects;
+  {
+    FixupContext fixup(schema_, buf_, starts, shifts,
+                       root_table_ ? *root_table_ : *schema_.root_table());
+    for (auto it = resizes_.begin(); it != resizes_.end(); ++it) {
+      objects.push_back(fixup.Map(buf_.data() + it->object));
+    }
+  }
+  // Clear what is being thrown away, since some of it remains in the buffer.
+  for (auto it = resizes_.begin(); it != resizes_.end(); ++it) {
+    auto data = buf_.data() + it->object + sizeof(uoffset_t);
+    if (!it->elem_size) {
+      memset(data, 0, it->old_size);
+    } else if (it->new_size < it->old_size) {
+      memset(data + it->new_size * it->elem_size, 0,
+             (it->old_size - it->new_size) * it->elem_size);
+    }
+  }
+  // Then copy the buffer once, inserting and removing bytes as we go.
+  std::vector<uint8_t> resized;
+  resized.reserve(buf_.size() + shifts.back());
+  uoffset_t pos = 0;
+  for (auto it = resizes_.begin(); it != resizes_.end(); ++it) {
+    assert(pos <= it->start);  // Resizes must not overlap.
+    resized.insert(resized.end(), buf_.begin() + pos, buf_.begin() + it->start);
+    if (it->delta > 0) resized.insert(resized.end(), it->delta, 0);
+    pos = it->start + (it->delta < 0 ? -it->delta : 0);
+  }
+  resized.insert(resized.end(), buf_.begin() + pos, buf_.end());
+  buf_.swap(resized);
+  // Finally set the new lengths and contents.
+  for (size_t i = 0; i < resizes_.size(); i++) {
+    auto &resize = resizes_[i];
+    auto object = buf_.data() + objects[i];
+    WriteScalar(object, resize.new_size);
+    auto data = object + sizeof(uoffset_t);
+    if (!resize.elem_size) {
+      memcpy(data, resize.data.c_str(), resize.new_size + 1);
+    } else if (!resize.data.empty()) {
+      for (auto j = resize.old_size; j < resize.new_size; j++) {
+        memcpy(data + j * resize.elem_size, resize.data.data(),
+               resize.elem_size);
+      }
+    }
+  }
+  resizes_.clear();
+}
+
 const uint8_t *AddFlatBuffer(std::vector<uint8_t> &flatbuf,
                              const uint8_t *newbuf, size_t newlen) {
   // Align to sizeof(uoffset_t) past sizeof(largest_scalar_t) since we're
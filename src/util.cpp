@@ -14,6 +14,22 @@
  * limitations under the License.
  */
 
+#include <errno.h>
+#ifdef _WIN32
+#include <io.h>
+#define FLATBUFFERS_READ(fd, buf, len) \
+  _read(fd, buf, static_cast<unsigned int>(len))
+#define FLATBUFFERS_WRITE(fd, buf, len) \
+  _write(fd, buf, static_cast<unsigned int>(len))
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define FLATBUFFERS_READ read
+#define FLATBUFFERS_WRITE write
+#endif
+
+#include "flatbuffers/json.h"
 #include "flatbuffers/util.h"
 
 namespace flatbuffers {
@@ -29,6 +45,13 @@ bool LoadFileRaw(const char *name, bool binary, std::string *buf) {
   if (!ifs.is_open()) return false;
   if (binary) {
     // The fastest way to read a file into a string.
+    MappedFile mapped;
+    if (mapped.Open(name, MappedFile::kAdviceSequential)) {
+      buf->assign(reinterpret_cast<const char *>(mapped.GetData()),
+                  mapped.GetSize());
+      return true;
+    }
+    // Not all files can be mapped (e.g. pipes), so fall back to reading.
     ifs.seekg(0, std::ios::end);
     auto size = ifs.tellg();
     (*buf).resize(static_cast<size_t>(size));
@@ -83,4 +106,216 @@ FileExistsFunction SetFileExistsFunction(
   return previous_function;
 }
 
+bool MappedFile::Open(const char *name, Advice advice) {
+  Close();
+  #ifdef _WIN32
+    auto file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING,
+                            advice == kAdviceSequential
+                              ? FILE_FLAG_SEQUENTIAL_SCAN
+                              : advice == kAdviceRandom
+                                ? FILE_FLAG_RANDOM_ACCESS
+                                : FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+      CloseHandle(file);
+      return false;
+    }
+    if (size.QuadPart) {
+      // The view keeps the mapping alive, so no need to hold on to either
+      // handle.
+      auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                        nullptr);
+      if (mapping) {
+        data_ = reinterpret_cast<const uint8_t *>(
+                  MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+      }
+      if (!data_) {
+        CloseHandle(file);
+        return false;
+      }
+      size_ = static_cast<size_t>(size.QuadPart);
+    }
+    CloseHandle(file);
+  #else
+    auto fd = open(name, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 || !S_ISREG(file_info.st_mode)) {
+      close(fd);
+      return false;
+    }
+    if (file_info.st_size) {
+      // The mapping stays valid after closing the file.
+      auto data = mmap(nullptr, static_cast<size_t>(file_info.st_size),
+                       PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        return false;
+      }
+      data_ = reinterpret_cast<const uint8_t *>(data);
+      size_ = static_cast<size_t>(file_info.st_size);
+      // This is only a hint, so failures don't matter.
+      switch (advice) {
+        case kAdviceNormal: break;
+        case kAdviceSequential: madvise(data, size_, MADV_SEQUENTIAL); break;
+        case kAdviceRandom: madvise(data, size_, MADV_RANDOM); break;
+        case kAdviceWillNeed: madvise(data, size_, MADV_WILLNEED); break;
+      }
+    }
+    close(fd);
+  #endif
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_) {
+    #ifdef _WIN32
+      UnmapViewOfFile(data_);
+    #else
+      munmap(const_cast<uint8_t *>(data_), size_);
+    #endif
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool SizePrefixedFileReader::Next(const uint8_t **buf, uoffset_t *len) {
+  if (!Fill(sizeof(uoffset_t))) {
+    truncated_ = !error_ && size_ != start_;
+    return false;
+  }
+  auto data = reinterpret_cast<const uint8_t *>(data_.data()) + start_;
+  auto size = GetPrefixedSize(data);
+  if (size > max_buffer_size_) {
+    error_ = true;
+    return false;
+  }
+  if (!Fill(sizeof(uoffset_t) + size)) {
+    truncated_ = !error_;
+    return false;
+  }
+  // Fill() may have moved the data.
+  data = reinterpret_cast<const uint8_t *>(data_.data()) + start_;
+  *buf = data + sizeof(uoffset_t);
+  *len = size;
+  start_ += sizeof(uoffset_t) + size;
+  return true;
+}
+
+bool SizePrefixedFileReader::Fill(size_t size) {
+  if (size_ - start_ >= size) return true;
+  if (error_) return false;
+  // Move the unread data to the front, and make sure it all fits.
+  auto data = reinterpret_cast<uint8_t *>(data_.data());
+  memmove(data, data + start_, size_ - start_);
+  size_ -= start_;
+  start_ = 0;
+  auto capacity = (std::max)(size, chunk_size_);
+  if (data_.size() * sizeof(largest_scalar_t) < capacity) {
+    data_.resize((capacity + sizeof(largest_scalar_t) - 1) /
+                 sizeof(largest_scalar_t));
+    data = reinterpret_cast<uint8_t *>(data_.data());
+  }
+  capacity = data_.size() * sizeof(largest_scalar_t);
+  while (size_ < size) {
+    auto bytes_read = FLATBUFFERS_READ(fd_, data + size_, capacity - size_);
+    if (bytes_read < 0) {
+      if (errno == EINTR) continue;
+      error_ = true;
+      return false;
+    }
+    if (bytes_read == 0) return false;  // End of file.
+    size_ += static_cast<size_t>(bytes_read);
+  }
+  return true;
+}
+
+bool SizePrefixedFileWriter::Write(const uint8_t *buf, size_t len) {
+  if (buffer_.size() + len > buffer_size_ && !Flush()) return false;
+  if (len >= buffer_size_) return WriteAll(buf, len);
+  buffer_.insert(buffer_.end(), buf, buf + len);
+  return true;
+}
+
+bool SizePrefixedFileWriter::Flush() {
+  if (!buffer_.empty()) {
+    WriteAll(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+  return !error_;
+}
+
+bool SizePrefixedFileWriter::WriteAll(const uint8_t *buf, size_t len) {
+  while (len && !error_) {
+    auto written = FLATBUFFERS_WRITE(fd_, buf, len);
+    if (written < 0) {
+      if (errno != EINTR) error_ = true;
+      continue;
+    }
+    if (!written) {  // No progress, e.g. a full device: don't spin.
+      error_ = true;
+      break;
+    }
+    buf += written;
+    len -= static_cast<size_t>(written);
+  }
+  return !error_;
+}
+
+BufferedTextSink::BufferedTextSink(OutputCallback output, void *context,
+                                   size_t buffer_size)
+    : output_(output), context_(context), release_(nullptr),
+      // Reserve() must always fit, so don't go below that.
+      buffer_(std::max(buffer_size,
+                       static_cast<size_t>(kMaxNumToCharsLength))) {
+  cur_ = buffer_.data();
+  end_ = cur_ + buffer_.size();
+}
+
+static bool WriteToFd(void *context, const char *text, size_t len) {
+  auto fd = static_cast<int>(reinterpret_cast<intptr_t>(context));
+  while (len) {
+    auto written = FLATBUFFERS_WRITE(fd, text, len);
+    if (written < 0) {
+      if (errno != EINTR) return false;
+      continue;
+    }
+    if (!written) return false;  // No progress: don't spin.
+    text += written;
+    len -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+static bool WriteToFile(void *context, const char *text, size_t len) {
+  return fwrite(text, 1, len, static_cast<FILE *>(context)) == len;
+}
+
+BufferedTextSink::BufferedTextSink(int fd, size_t buffer_size)
+    : BufferedTextSink(WriteToFd, reinterpret_cast<void *>(
+                                    static_cast<intptr_t>(fd)),
+                       buffer_size) {}
+
+BufferedTextSink::BufferedTextSink(FILE *file, size_t buffer_size)
+    : BufferedTextSink(WriteToFile, file, buffer_size) {}
+
+bool BufferedTextSink::Flush() {
+  auto len = static_cast<size_t>(cur_ - buffer_.data());
+  // After an error, text is dropped, but we keep accepting it.
+  if (len && !error_ && !output_(context_, buffer_.data(), len))
+    error_ = true;
+  cur_ = buffer_.data();
+  return !error_;
+}
+
+void BufferedTextSink::Grow(size_t len) {
+  assert(len <= buffer_.size());
+  (void)len;
+  Flush();
+}
+
 }  // namespace flatbuffers
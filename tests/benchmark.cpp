@@ -0,0 +1,358 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Micro benchmarks of the main operations of the C++ library, using the test
+// and sample schemas. Run this from the directory that contains tests/ (like
+// flattests). Results are written to stdout as JSON, such that they can be
+// compared between releases:
+//
+//   flatbenchmark [--min_time=<seconds>] [--filter=<substring>]
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/json.h"
+#include "flatbuffers/reflection.h"
+#include "flatbuffers/util.h"
+
+#include "monster_test_generated.h"
+#include "monster_generated.h"
+
+namespace Example = MyGame::Example;
+namespace Sample = MyGame::Sample;
+
+namespace {
+
+double min_time = 0.5;
+const char *filter = "";
+bool first_result = true;
+
+// Written to by benchmarks, such that the compiler can't optimize them away.
+volatile size_t sink = 0;
+
+// Runs f repeatedly until min_time has passed, and prints the result.
+// bytes is the amount of data f processes per call, to compute throughput.
+template<typename F> void Benchmark(const char *name, size_t bytes, F f) {
+  if (!strstr(name, filter)) return;
+  typedef std::chrono::steady_clock clock;
+  f();  // Warm up.
+  size_t iterations = 0;
+  double seconds = 0;
+  for (size_t batch = 1; seconds < min_time; batch *= 2) {
+    auto start = clock::now();
+    for (size_t i = 0; i < batch; i++) f();
+    seconds += std::chrono::duration<double>(clock::now() - start).count();
+    iterations += batch;
+  }
+  printf("%s\n    { \"name\": \"%s\", \"iterations\": %lu, "
+         "\"ns_per_iteration\": %.1f, \"bytes_per_iteration\": %lu, "
+         "\"mb_per_second\": %.2f }",
+         first_result ? "" : ",", name,
+         static_cast<unsigned long>(iterations),
+         seconds * 1e9 / iterations, static_cast<unsigned long>(bytes),
+         bytes * iterations / seconds / (1024 * 1024));
+  first_result = false;
+}
+
+// The same monster flattests uses.
+void BuildExampleMonster(flatbuffers::FlatBufferBuilder &fbb) {
+  auto vec = Example::Vec3(1, 2, 3, 0, Example::Color_Red,
+                           Example::Test(10, 20));
+  auto name = fbb.CreateString("MyMonster");
+  unsigned char inv_data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  auto inventory = fbb.CreateVector(inv_data, 10);
+  Example::Test tests[] = { Example::Test(10, 20), Example::Test(30, 40) };
+  auto testv = fbb.CreateVectorOfStructs(tests, 2);
+  flatbuffers::Offset<Example::Monster> mlocs[3];
+  const char *names[] = { "Fred", "Barney", "Wilma" };
+  for (int i = 0; i < 3; i++) {
+    mlocs[i] = Example::CreateMonster(fbb, nullptr, 150, 1000,
+                                      fbb.CreateString(names[i]));
+  }
+  std::vector<std::string> strings;
+  strings.push_back("bob");
+  strings.push_back("fred");
+  auto vecofstrings = fbb.CreateVectorOfStrings(strings);
+  auto vecoftables = fbb.CreateVectorOfSortedTables(mlocs, 3);
+  auto mloc = Example::CreateMonster(fbb, &vec, 150, 80, name, inventory,
+                                     Example::Color_Blue, Example::Any_Monster,
+                                     mlocs[1].Union(), testv, vecofstrings,
+                                     vecoftables);
+  Example::FinishMonsterBuffer(fbb, mloc);
+}
+
+// The monster from the tutorial.
+void BuildSampleMonster(flatbuffers::FlatBufferBuilder &fbb) {
+  auto sword = Sample::CreateWeapon(fbb, fbb.CreateString("Sword"), 3);
+  auto axe = Sample::CreateWeapon(fbb, fbb.CreateString("Axe"), 5);
+  flatbuffers::Offset<Sample::Weapon> weapons_data[] = { sword, axe };
+  auto weapons = fbb.CreateVector(weapons_data, 2);
+  auto position = Sample::Vec3(1.0f, 2.0f, 3.0f);
+  auto name = fbb.CreateString("MyMonster");
+  unsigned char inv_data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  auto inventory = fbb.CreateVector(inv_data, 10);
+  fbb.Finish(Sample::CreateMonster(fbb, &position, 150, 80, name, inventory,
+                                   Sample::Color_Red, weapons,
+                                   Sample::Equipment_Weapon, axe.Union()));
+}
+
+// Reads most fields, the way an application would.
+size_t ReadExampleMonster(const uint8_t *buf) {
+  auto monster = Example::GetMonster(buf);
+  size_t sum = monster->hp() + monster->mana() + monster->pos()->test3().a();
+  sum += monster->name()->size();
+  for (auto it = monster->inventory()->begin();
+       it != monster->inventory()->end(); ++it)
+    sum += *it;
+  for (auto it = monster->testarrayofstring()->begin();
+       it != monster->testarrayofstring()->end(); ++it)
+    sum += it->size();
+  for (auto it = monster->testarrayoftables()->begin();
+       it != monster->testarrayoftables()->end(); ++it)
+    sum += it->hp() + it->name()->size();
+  auto enemy = static_cast<const Example::Monster *>(monster->test());
+  return sum + enemy->hp();
+}
+
+size_t ReadSampleMonster(const uint8_t *buf) {
+  auto monster = Sample::GetMonster(buf);
+  size_t sum = monster->hp() + monster->mana() + monster->name()->size();
+  sum += static_cast<size_t>(monster->pos()->z());
+  for (auto it = monster->inventory()->begin();
+       it != monster->inventory()->end(); ++it)
+    sum += *it;
+  for (auto it = monster->weapons()->begin();
+       it != monster->weapons()->end(); ++it)
+    sum += it->damage() + it->name()->size();
+  return sum;
+}
+
+bool Load(const char *name, bool binary, std::string *buf) {
+  if (flatbuffers::LoadFile(name, binary, buf)) return true;
+  fprintf(stderr, "cannot load %s, run this from the directory that contains "
+                  "tests/\n", name);
+  return false;
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.find("--min_time=") == 0) {
+      min_time = atof(arg.c_str() + strlen("--min_time="));
+    } else if (arg.find("--filter=") == 0) {
+      filter = argv[i] + strlen("--filter=");
+    } else {
+      fprintf(stderr, "usage: %s [--min_time=<seconds>] "
+                      "[--filter=<substring>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  std::string schema, json, bfbs;
+  if (!Load("tests/monster_test.fbs", false, &schema) ||
+      !Load("tests/monsterdata_test.golden", false, &json) ||
+      !Load("tests/monster_test.bfbs", true, &bfbs))
+    return 1;
+
+  flatbuffers::FlatBufferBuilder fbb;
+  BuildExampleMonster(fbb);
+  std::vector<uint8_t> example(fbb.GetBufferPointer(),
+                               fbb.GetBufferPointer() + fbb.GetSize());
+  fbb.Clear();
+  BuildSampleMonster(fbb);
+  std::vector<uint8_t> sample(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+
+  printf("{\n  \"benchmarks\": [");
+
+  // Builder.
+  Benchmark("encode_example_monster", example.size(), [&]() {
+    fbb.Clear();
+    BuildExampleMonster(fbb);
+  });
+  Benchmark("encode_sample_monster", sample.size(), [&]() {
+    fbb.Clear();
+    BuildSampleMonster(fbb);
+  });
+
+  // Accessors.
+  Benchmark("decode_example_monster", example.size(), [&]() {
+    sink += ReadExampleMonster(example.data());
+  });
+  Benchmark("decode_sample_monster", sample.size(), [&]() {
+    sink += ReadSampleMonster(sample.data());
+  });
+
+  // Verifier.
+  Benchmark("verify_example_monster", example.size(), [&]() {
+    flatbuffers::Verifier verifier(example.data(), example.size());
+    sink += Example::VerifyMonsterBuffer(verifier);
+  });
+  Benchmark("verify_sample_monster", sample.size(), [&]() {
+    flatbuffers::Verifier verifier(sample.data(), sample.size());
+    sink += Sample::VerifyMonsterBuffer(verifier);
+  });
+
+  // Text parsing and generation.
+  const char *include_directories[] = { "tests", nullptr };
+  Benchmark("parse_schema", schema.size(), [&]() {
+    flatbuffers::Parser parser;
+    sink += parser.Parse(schema.c_str(), include_directories);
+  });
+  Benchmark("load_binary_schema", bfbs.size(), [&]() {
+    flatbuffers::Parser parser;
+    sink += parser.Deserialize(reinterpret_cast<const uint8_t *>(bfbs.c_str()));
+  });
+  flatbuffers::Parser parser;
+  if (!parser.Parse(schema.c_str(), include_directories)) {
+    fprintf(stderr, "%s\n", parser.error_.c_str());
+    return 1;
+  }
+  Benchmark("parse_json", json.size(), [&]() {
+    sink += parser.Parse(json.c_str(), include_directories);
+  });
+  // The same, through the code flatc --gen-json generates.
+  Benchmark("parse_json_compiled", json.size(), [&]() {
+    fbb.Clear();
+    sink += Example::Monster::ParseJson(json.c_str(), json.size(), fbb);
+  });
+  // Monsters nested through their union, with each value before its type,
+  // the way writers that sort keys alphabetically output them.
+  std::string nested = "{ name: \"Fred\" }";
+  for (int i = 0; i < 8; i++) {
+    nested = "{ name: \"Monster\", test: " + nested + ", test_type: Monster }";
+  }
+  Benchmark("parse_json_union_first", nested.size(), [&]() {
+    sink += parser.Parse(nested.c_str(), include_directories);
+  });
+  // A stream of small objects, one per line.
+  std::string stream;
+  for (int i = 0; i < 1000; i++) {
+    stream += "{ name: \"Monster " + flatbuffers::NumToString(i) +
+              "\", hp: " + flatbuffers::NumToString(i % 200) +
+              ", color: Green, inventory: [ 1, 2, 3 ] }\n";
+  }
+  Benchmark("parse_json_stream", stream.size(), [&]() {
+    sink += parser.ParseJsonStream(stream.c_str(), stream.size(),
+        [&](const flatbuffers::FlatBufferBuilder &builder) {
+          sink += builder.GetSize();
+          return true;
+        }, true);
+  });
+  std::string text;
+  GenerateText(parser, example.data(), &text);
+  Benchmark("generate_text", text.size(), [&]() {
+    text.clear();
+    sink += GenerateText(parser, example.data(), &text);
+  });
+  // The same, through the code flatc --gen-json generates.
+  Benchmark("generate_text_compiled", text.size(), [&]() {
+    text.clear();
+    flatbuffers::StringTextSink compiled(&text);
+    sink += Example::GetMonster(example.data())->ToJson(compiled);
+  });
+  // Into a fixed size buffer, without whitespace, as flatc writes files.
+  flatbuffers::BufferedTextSink buffered([&](const char *, size_t len) {
+    sink += len;
+    return true;
+  });
+  parser.opts.compact_json = true;
+  Benchmark("generate_text_compact", text.size(), [&]() {
+    sink += GenerateText(parser, example.data(), &buffered);
+    buffered.Flush();
+  });
+  parser.opts.compact_json = false;
+  // Mostly text, like log messages, with the odd character to escape.
+  std::vector<std::string> messages;
+  for (int i = 0; i < 100; i++) {
+    messages.push_back("request " + flatbuffers::NumToString(i) +
+                       " from \"client\" finished after 12 ms, with "
+                       "status OK and no retries needed at all \xE2\x9C\x93");
+  }
+  fbb.Clear();
+  Example::FinishMonsterBuffer(fbb, Example::CreateMonster(fbb, nullptr, 150,
+      100, fbb.CreateString("Logger"), 0, Example::Color_Blue,
+      Example::Any_NONE, 0, 0, fbb.CreateVectorOfStrings(messages)));
+  std::vector<uint8_t> logs(fbb.GetBufferPointer(),
+                            fbb.GetBufferPointer() + fbb.GetSize());
+  text.clear();
+  GenerateText(parser, logs.data(), &text);
+  Benchmark("generate_text_strings", text.size(), [&]() {
+    text.clear();
+    sink += GenerateText(parser, logs.data(), &text);
+  });
+
+  // Reflection.
+  auto &reflection_schema = *reflection::GetSchema(bfbs.c_str());
+  auto &root_table = *reflection_schema.root_table();
+  auto &name_field = *root_table.fields()->LookupByKey("name");
+  Benchmark("reflection_copy_table", example.size(), [&]() {
+    fbb.Clear();
+    fbb.Finish(flatbuffers::CopyTable(fbb, reflection_schema, root_table,
+                                      *flatbuffers::GetAnyRoot(example.data())));
+  });
+  std::vector<uint8_t> resizing;
+  Benchmark("reflection_set_string", example.size(), [&]() {
+    resizing.assign(example.begin(), example.end());
+    auto &root = *flatbuffers::GetAnyRoot(resizing.data());
+    flatbuffers::SetString(reflection_schema, "a much longer name than before",
+                           flatbuffers::GetFieldS(root, name_field),
+                           &resizing);
+  });
+  // Every string in a vector of them, one at a time or all at once.
+  auto &strings_field = *root_table.fields()->LookupByKey("testarrayofstring");
+  typedef flatbuffers::Offset<flatbuffers::String> StringOffset;
+  Benchmark("reflection_set_strings", logs.size(), [&]() {
+    resizing.assign(logs.begin(), logs.end());
+    for (flatbuffers::uoffset_t i = 0; i < messages.size(); i++) {
+      auto &root = *flatbuffers::GetAnyRoot(resizing.data());
+      flatbuffers::SetString(reflection_schema, "done",
+          flatbuffers::GetFieldV<StringOffset>(root, strings_field)->Get(i),
+          &resizing);
+    }
+  });
+  Benchmark("reflection_set_strings_transaction", logs.size(), [&]() {
+    resizing.assign(logs.begin(), logs.end());
+    auto &root = *flatbuffers::GetAnyRoot(resizing.data());
+    auto strings = flatbuffers::GetFieldV<StringOffset>(root, strings_field);
+    flatbuffers::ResizeTransaction transaction(reflection_schema, &resizing);
+    for (flatbuffers::uoffset_t i = 0; i < strings->size(); i++) {
+      transaction.SetString("done", strings->Get(i));
+    }
+    transaction.Commit();
+  });
+
+  // Object API.
+  Benchmark("unpack_example_monster", example.size(), [&]() {
+    sink += Example::GetMonster(example.data())->UnPack()->hp;
+  });
+  auto unpacked = Example::GetMonster(example.data())->UnPack();
+  Benchmark("pack_example_monster", example.size(), [&]() {
+    fbb.Clear();
+    Example::FinishMonsterBuffer(fbb, Example::CreateMonster(fbb,
+                                                             unpacked.get()));
+  });
+
+  printf("\n  ]\n}\n");
+  return 0;
+}
@@ -0,0 +1,317 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+#ifndef FLATBUFFERS_GENERATED_DEFAULTSJSONTEST_DEFAULTSJSON_H_
+#define FLATBUFFERS_GENERATED_DEFAULTSJSONTEST_DEFAULTSJSON_H_
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/hash.h"
+#include "flatbuffers/json.h"
+
+namespace DefaultsJson {
+
+struct Defaults;
+struct DefaultsT;
+
+enum Color {
+  Color_Red = 1,
+  Color_Green = 2,
+  Color_Blue = 8,
+  Color_MIN = Color_Red,
+  Color_MAX = Color_Blue
+};
+
+inline const char **EnumNamesColor() {
+  static const char *names[] = { "Red", "Green", "", "", "", "", "", "Blue", nullptr };
+  return names;
+}
+
+inline const char *EnumNameColor(Color e) { return EnumNamesColor()[static_cast<int>(e) - static_cast<int>(Color_Red)]; }
+
+inline bool EnumValueColor(const char *name, size_t length, int64_t *value) {
+  switch (length) {
+    case 3:
+      if (!memcmp(name, "Red", 3)) { *value = 1; return true; }
+      break;
+    case 4:
+      if (!memcmp(name, "Blue", 4)) { *value = 8; return true; }
+      break;
+    case 5:
+      if (!memcmp(name, "Green", 5)) { *value = 2; return true; }
+      break;
+  }
+  return false;
+}
+
+struct DefaultsT : public flatbuffers::NativeTable {
+  bool flag;
+  Color color;
+  float ratio;
+  int32_t count;
+  std::string name;
+};
+
+struct Defaults FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  enum {
+    VT_FLAG = 4,
+    VT_COLOR = 6,
+    VT_RATIO = 8,
+    VT_COUNT = 10,
+    VT_NAME = 12
+  };
+  bool flag() const { return GetField<uint8_t>(VT_FLAG, 1) != 0; }
+  bool mutate_flag(bool _flag) { return SetField(VT_FLAG, static_cast<uint8_t>(_flag)); }
+  Color color() const { return static_cast<Color>(GetField<int8_t>(VT_COLOR, 8)); }
+  bool mutate_color(Color _color) { return SetField(VT_COLOR, static_cast<int8_t>(_color)); }
+  float ratio() const { return GetField<float>(VT_RATIO, 0.5f); }
+  bool mutate_ratio(float _ratio) { return SetField(VT_RATIO, _ratio); }
+  int32_t count() const { return GetField<int32_t>(VT_COUNT, -7); }
+  bool mutate_count(int32_t _count) { return SetField(VT_COUNT, _count); }
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(VT_NAME); }
+  flatbuffers::String *mutable_name() { return GetPointer<flatbuffers::String *>(VT_NAME); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint8_t>(verifier, VT_FLAG) &&
+           VerifyField<int8_t>(verifier, VT_COLOR) &&
+           VerifyField<float>(verifier, VT_RATIO) &&
+           VerifyField<int32_t>(verifier, VT_COUNT) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, VT_NAME) &&
+           verifier.Verify(name()) &&
+           verifier.EndTable();
+  }
+  std::unique_ptr<DefaultsT> UnPack() const;
+  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) const;
+  static bool ParseJson(flatbuffers::JsonScanner &json,
+      flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Defaults> *result);
+  static bool ParseJson(const char *json, size_t length,
+      flatbuffers::FlatBufferBuilder &fbb, std::string *error = nullptr);
+};
+
+struct DefaultsBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_flag(bool flag) { fbb_.AddElement<uint8_t>(Defaults::VT_FLAG, static_cast<uint8_t>(flag), 1); }
+  void add_color(Color color) { fbb_.AddElement<int8_t>(Defaults::VT_COLOR, static_cast<int8_t>(color), 8); }
+  void add_ratio(float ratio) { fbb_.AddElement<float>(Defaults::VT_RATIO, ratio, 0.5f); }
+  void add_count(int32_t count) { fbb_.AddElement<int32_t>(Defaults::VT_COUNT, count, -7); }
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(Defaults::VT_NAME, name); }
+  DefaultsBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  DefaultsBuilder &operator=(const DefaultsBuilder &);
+  flatbuffers::Offset<Defaults> Finish() {
+    auto o = flatbuffers::Offset<Defaults>(fbb_.EndTable(start_, 5));
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Defaults> CreateDefaults(flatbuffers::FlatBufferBuilder &_fbb,
+    bool flag = true,
+    Color color = Color_Blue,
+    float ratio = 0.5f,
+    int32_t count = -7,
+    flatbuffers::Offset<flatbuffers::String> name = 0) {
+  DefaultsBuilder builder_(_fbb);
+  builder_.add_name(name);
+  builder_.add_count(count);
+  builder_.add_ratio(ratio);
+  builder_.add_color(color);
+  builder_.add_flag(flag);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Defaults> CreateDefaultsDirect(flatbuffers::FlatBufferBuilder &_fbb,
+    bool flag = true,
+    Color color = Color_Blue,
+    float ratio = 0.5f,
+    int32_t count = -7,
+    const char *name = nullptr) {
+  return CreateDefaults(_fbb, flag, color, ratio, count, name ? _fbb.CreateString(name) : 0);
+}
+
+inline flatbuffers::Offset<Defaults> CreateDefaults(flatbuffers::FlatBufferBuilder &_fbb, const DefaultsT *_o);
+
+inline std::unique_ptr<DefaultsT> Defaults::UnPack() const {
+  auto _o = new DefaultsT();
+  { auto _e = flag(); _o->flag = _e; };
+  { auto _e = color(); _o->color = _e; };
+  { auto _e = ratio(); _o->ratio = _e; };
+  { auto _e = count(); _o->count = _e; };
+  { auto _e = name(); if (_e) _o->name = _e->str(); };
+  return std::unique_ptr<DefaultsT>(_o);
+}
+
+inline flatbuffers::Offset<Defaults> CreateDefaults(flatbuffers::FlatBufferBuilder &_fbb, const DefaultsT *_o) {
+  return CreateDefaults(_fbb,
+    _o->flag,
+    _o->color,
+    _o->ratio,
+    _o->count,
+    _o->name.size() ? _fbb.CreateString(_o->name) : 0);
+}
+
+inline bool Defaults::ToJson(flatbuffers::TextSink &sink, int indent) const {
+  sink += '{';
+  auto _sep = "\n";
+  {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("flag: ", 6);
+    auto _v = GetField<uint8_t>(VT_FLAG, 1);
+    sink += _v != 0 ? "true" : "false";
+  }
+  {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("color: ", 7);
+    auto _v = GetField<int8_t>(VT_COLOR, 8);
+    switch (static_cast<int>(_v)) {
+      case 1:
+        sink.Append("Red", 3);
+        break;
+      case 2:
+        sink.Append("Green", 5);
+        break;
+      case 8:
+        sink.Append("Blue", 4);
+        break;
+      default: sink.AppendNumber(_v);
+    }
+  }
+  {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("ratio: ", 7);
+    auto _v = GetField<float>(VT_RATIO, 0.5f);
+    sink.AppendNumber(_v);
+  }
+  {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("count: ", 7);
+    auto _v = GetField<int32_t>(VT_COUNT, -7);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_NAME)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("name: ", 6);
+    auto _v = GetPointer<const flatbuffers::String *>(VT_NAME);
+    if (!flatbuffers::EscapeJsonString(_v->c_str(), _v->size(), false, &sink)) return false;
+  }
+  sink += '\n';
+  sink.Fill(indent, ' ');
+  sink += '}';
+  return true;
+}
+
+inline bool Defaults::ParseJson(flatbuffers::JsonScanner &json,
+    flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Defaults> *result) {
+  uint8_t _flag = 0;
+  int8_t _color = 0;
+  float _ratio = 0;
+  int32_t _count = 0;
+  flatbuffers::Offset<flatbuffers::String> _name;
+  bool set[5] = {};
+  if (!json.Expect('{')) return false;
+  for (bool more = !json.Is('}'); more; ) {
+    const char *key = nullptr;
+    size_t key_length = 0;
+    if (!json.ParseFieldName(false, &key, &key_length)) return false;
+    int field = -1;
+    switch (key_length) {
+      case 4:
+        if (!memcmp(key, "flag", 4)) field = 0;
+        else if (!memcmp(key, "name", 4)) field = 4;
+        break;
+      case 5:
+        if (!memcmp(key, "color", 5)) field = 1;
+        else if (!memcmp(key, "ratio", 5)) field = 2;
+        else if (!memcmp(key, "count", 5)) field = 3;
+        break;
+    }
+    if (field < 0) {
+      return json.Error("unknown field: " + std::string(key, key_length));
+    } else if (!json.Expect(':')) {
+      return false;
+    } else if (json.Is(flatbuffers::JsonScanner::kTokenNull)) {
+      if (!json.Next()) return false;  // Ignore this field.
+    } else if (set[field]) {
+      return json.Error("field set more than once: " +
+                        std::string(key, key_length));
+    } else {
+      switch (field) {
+        case 0: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 64, &i)) return false;
+          _flag = i != 0;
+          break;
+        }
+        case 1: {
+          int64_t i;
+          if (!json.ParseInteger(EnumValueColor, 8, &i)) return false;
+          _color = static_cast<int8_t>(i);
+          break;
+        }
+        case 2: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _ratio = static_cast<float>(d);
+          break;
+        }
+        case 3: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 32, &i)) return false;
+          _count = static_cast<int32_t>(i);
+          break;
+        }
+        case 4: {
+          if (!json.ParseString(false, fbb, &_name)) return false;
+          break;
+        }
+      }
+      set[field] = true;
+    }
+    if (!json.Is(',')) break;
+    if (!json.Next()) return false;
+    more = !json.Is('}');
+  }
+  if (!json.Expect('}')) return false;
+  DefaultsBuilder builder_(fbb);
+  if (set[4]) builder_.add_name(_name);
+  if (set[3]) builder_.add_count(_count);
+  if (set[2]) builder_.add_ratio(_ratio);
+  if (set[1]) builder_.add_color(static_cast<Color>(_color));
+  if (set[0]) builder_.add_flag(_flag != 0);
+  *result = builder_.Finish();
+  return true;
+}
+
+inline bool Defaults::ParseJson(const char *json, size_t length,
+    flatbuffers::FlatBufferBuilder &fbb, std::string *error) {
+  flatbuffers::JsonScanner scanner(json, length);
+  flatbuffers::Offset<Defaults> root;
+  if (scanner.Next() && ParseJson(scanner, fbb, &root)) {
+    if (scanner.Is(flatbuffers::JsonScanner::kTokenEof)) {
+      fbb.Finish(root);
+      return true;
+    }
+    scanner.Error("cannot have more than one json object");
+  }
+  if (error) *error = scanner.error();
+  return false;
+}
+
+inline const DefaultsJson::Defaults *GetDefaults(const void *buf) { return flatbuffers::GetRoot<DefaultsJson::Defaults>(buf); }
+
+inline Defaults *GetMutableDefaults(void *buf) { return flatbuffers::GetMutableRoot<Defaults>(buf); }
+
+inline bool VerifyDefaultsBuffer(flatbuffers::Verifier &verifier) { return verifier.VerifyBuffer<DefaultsJson::Defaults>(nullptr); }
+
+inline void FinishDefaultsBuffer(flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<DefaultsJson::Defaults> root) { fbb.Finish(root); }
+
+}  // namespace DefaultsJson
+
+#endif  // FLATBUFFERS_GENERATED_DEFAULTSJSONTEST_DEFAULTSJSON_H_
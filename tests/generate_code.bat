@@ -15,6 +15,7 @@
 set buildtype=Release
 if "%1"=="-b" set buildtype=%2
 
-..\%buildtype%\flatc.exe --cpp --java --csharp --go --binary --python --js --php --grpc --gen-mutable --gen-object-api --no-includes monster_test.fbs monsterdata_test.json
+..\%buildtype%\flatc.exe --cpp --java --csharp --go --binary --python --js --php --grpc --gen-mutable --gen-object-api --gen-json --no-includes monster_test.fbs monsterdata_test.json
+..\%buildtype%\flatc.exe --cpp --gen-mutable --gen-object-api --gen-json --defaults-json --no-includes defaults_json_test.fbs
 ..\%buildtype%\flatc.exe --cpp --java --csharp --go --binary --python --js --php --gen-mutable -o namespace_test namespace_test\namespace_test1.fbs namespace_test\namespace_test2.fbs
 ..\%buildtype%\flatc.exe --binary --schema monster_test.fbs
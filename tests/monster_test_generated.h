@@ -4,6 +4,8 @@
 #define FLATBUFFERS_GENERATED_MONSTERTEST_MYGAME_EXAMPLE_H_
 
 #include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/hash.h"
+#include "flatbuffers/json.h"
 
 namespace MyGame {
 namespace Example2 {
@@ -43,6 +45,21 @@ inline const char **EnumNamesColor() {
 
 inline const char *EnumNameColor(Color e) { return EnumNamesColor()[static_cast<int>(e) - static_cast<int>(Color_Red)]; }
 
+inline bool EnumValueColor(const char *name, size_t length, int64_t *value) {
+  switch (length) {
+    case 3:
+      if (!memcmp(name, "Red", 3)) { *value = 1; return true; }
+      break;
+    case 4:
+      if (!memcmp(name, "Blue", 4)) { *value = 8; return true; }
+      break;
+    case 5:
+      if (!memcmp(name, "Green", 5)) { *value = 2; return true; }
+      break;
+  }
+  return false;
+}
+
 enum Any {
   Any_NONE = 0,
   Any_Monster = 1,
@@ -94,6 +111,22 @@ template<> struct AnyTraits<MyGame::Example2::Monster> {
 
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, Any type);
 
+inline bool EnumValueAny(const char *name, size_t length, int64_t *value) {
+  switch (length) {
+    case 4:
+      if (!memcmp(name, "NONE", 4)) { *value = 0; return true; }
+      break;
+    case 7:
+      if (!memcmp(name, "Monster", 7)) { *value = 1; return true; }
+      break;
+    case 23:
+      if (!memcmp(name, "TestSimpleTableWithEnum", 23)) { *value = 2; return true; }
+      else if (!memcmp(name, "MyGame_Example2_Monster", 23)) { *value = 3; return true; }
+      break;
+  }
+  return false;
+}
+
 MANUALLY_ALIGNED_STRUCT(2) Test FLATBUFFERS_FINAL_CLASS {
  private:
   int16_t a_;
@@ -103,6 +136,7 @@ MANUALLY_ALIGNED_STRUCT(2) Test FLATBUFFERS_FINAL_CLASS {
  public:
   Test() { memset(this, 0, sizeof(Test)); }
   Test(const Test &_o) { memcpy(this, &_o, sizeof(Test)); }
+  Test &operator=(const Test &) = default;
   Test(int16_t _a, int8_t _b)
     : a_(flatbuffers::EndianScalar(_a)), b_(flatbuffers::EndianScalar(_b)), __padding0(0) { (void)__padding0; }
 
@@ -110,6 +144,8 @@ MANUALLY_ALIGNED_STRUCT(2) Test FLATBUFFERS_FINAL_CLASS {
   void mutate_a(int16_t _a) { flatbuffers::WriteScalar(&a_, _a); }
   int8_t b() const { return flatbuffers::EndianScalar(b_); }
   void mutate_b(int8_t _b) { flatbuffers::WriteScalar(&b_, _b); }
+  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) const;
+  static bool ParseJson(flatbuffers::JsonScanner &json, Test *result);
 };
 STRUCT_END(Test, 4);
 
@@ -128,6 +164,7 @@ MANUALLY_ALIGNED_STRUCT(16) Vec3 FLATBUFFERS_FINAL_CLASS {
  public:
   Vec3() { memset(this, 0, sizeof(Vec3)); }
   Vec3(const Vec3 &_o) { memcpy(this, &_o, sizeof(Vec3)); }
+  Vec3 &operator=(const Vec3 &) = default;
   Vec3(float _x, float _y, float _z, double _test1, Color _test2, const Test &_test3)
     : x_(flatbuffers::EndianScalar(_x)), y_(flatbuffers::EndianScalar(_y)), z_(flatbuffers::EndianScalar(_z)), __padding0(0), test1_(flatbuffers::EndianScalar(_test1)), test2_(flatbuffers::EndianScalar(static_cast<int8_t>(_test2))), __padding1(0), test3_(_test3), __padding2(0) { (void)__padding0; (void)__padding1; (void)__padding2; }
 
@@ -143,6 +180,8 @@ MANUALLY_ALIGNED_STRUCT(16) Vec3 FLATBUFFERS_FINAL_CLASS {
   void mutate_test2(Color _test2) { flatbuffers::WriteScalar(&test2_, static_cast<int8_t>(_test2)); }
   const Test &test3() const { return test3_; }
   Test &mutable_test3() { return test3_; }
+  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) const;
+  static bool ParseJson(flatbuffers::JsonScanner &json, Vec3 *result);
 };
 STRUCT_END(Vec3, 32);
 
@@ -159,6 +198,11 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.EndTable();
   }
   std::unique_ptr<MonsterT> UnPack() const;
+  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) const;
+  static bool ParseJson(flatbuffers::JsonScanner &json,
+      flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Monster> *result);
+  static bool ParseJson(const char *json, size_t length,
+      flatbuffers::FlatBufferBuilder &fbb, std::string *error = nullptr);
 };
 
 struct MonsterBuilder {
@@ -199,6 +243,11 @@ struct TestSimpleTableWithEnum FLATBUFFERS_FINAL_CLASS : private flatbuffers::Ta
            verifier.EndTable();
   }
   std::unique_ptr<TestSimpleTableWithEnumT> UnPack() const;
+  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) const;
+  static bool ParseJson(flatbuffers::JsonScanner &json,
+      flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<TestSimpleTableWithEnum> *result);
+  static bool ParseJson(const char *json, size_t length,
+      flatbuffers::FlatBufferBuilder &fbb, std::string *error = nullptr);
 };
 
 struct TestSimpleTableWithEnumBuilder {
@@ -249,6 +298,11 @@ struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.EndTable();
   }
   std::unique_ptr<StatT> UnPack() const;
+  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) const;
+  static bool ParseJson(flatbuffers::JsonScanner &json,
+      flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Stat> *result);
+  static bool ParseJson(const char *json, size_t length,
+      flatbuffers::FlatBufferBuilder &fbb, std::string *error = nullptr);
 };
 
 struct StatBuilder {
@@ -455,6 +509,11 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.EndTable();
   }
   std::unique_ptr<MonsterT> UnPack() const;
+  bool ToJson(flatbuffers::TextSink &sink, int indent = 0) const;
+  static bool ParseJson(flatbuffers::JsonScanner &json,
+      flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Monster> *result);
+  static bool ParseJson(const char *json, size_t length,
+      flatbuffers::FlatBufferBuilder &fbb, std::string *error = nullptr);
 };
 
 struct MonsterBuilder {
@@ -701,6 +760,1252 @@ inline flatbuffers::Offset<Monster> CreateMonster(flatbuffers::FlatBufferBuilder
     _o->testarrayofstring2.size() ? _fbb.CreateVectorOfStrings(_o->testarrayofstring2) : 0);
 }
 
+}  // namespace Example
+
+namespace Example2 {
+
+inline bool Monster::ToJson(flatbuffers::TextSink &sink, int indent) const {
+  sink += '{';
+  sink += '\n';
+  sink.Fill(indent, ' ');
+  sink += '}';
+  return true;
+}
+
+inline bool Monster::ParseJson(flatbuffers::JsonScanner &json,
+    flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Monster> *result) {
+  if (!json.Expect('{')) return false;
+  for (bool more = !json.Is('}'); more; ) {
+    const char *key = nullptr;
+    size_t key_length = 0;
+    if (!json.ParseFieldName(false, &key, &key_length)) return false;
+    return json.Error("unknown field: " + std::string(key, key_length));
+  }
+  if (!json.Expect('}')) return false;
+  MonsterBuilder builder_(fbb);
+  *result = builder_.Finish();
+  return true;
+}
+
+inline bool Monster::ParseJson(const char *json, size_t length,
+    flatbuffers::FlatBufferBuilder &fbb, std::string *error) {
+  flatbuffers::JsonScanner scanner(json, length);
+  flatbuffers::Offset<Monster> root;
+  if (scanner.Next() && ParseJson(scanner, fbb, &root)) {
+    if (scanner.Is(flatbuffers::JsonScanner::kTokenEof)) {
+      fbb.Finish(root);
+      return true;
+    }
+    scanner.Error("cannot have more than one json object");
+  }
+  if (error) *error = scanner.error();
+  return false;
+}
+
+}  // namespace Example2
+
+namespace Example {
+
+inline bool Test::ToJson(flatbuffers::TextSink &sink, int indent) const {
+  sink += '{';
+  {
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink.Append("a: ", 3);
+    auto _v = flatbuffers::EndianScalar(a_);
+    sink.AppendNumber(_v);
+  }
+  {
+    sink.Append(",\n", 2);
+    sink.Fill(indent + 2, ' ');
+    sink.Append("b: ", 3);
+    auto _v = flatbuffers::EndianScalar(b_);
+    sink.AppendNumber(_v);
+  }
+  sink += '\n';
+  sink.Fill(indent, ' ');
+  sink += '}';
+  return true;
+}
+
+inline bool Test::ParseJson(flatbuffers::JsonScanner &json, Test *result) {
+  int16_t _a = 0;
+  int8_t _b = 0;
+  bool set[2] = {};
+  size_t count = 0;
+  if (!json.Expect('{')) return false;
+  for (bool more = !json.Is('}'); more; ) {
+    const char *key = nullptr;
+    size_t key_length = 0;
+    if (!json.ParseFieldName(false, &key, &key_length)) return false;
+    int field = -1;
+    switch (key_length) {
+      case 1:
+        if (!memcmp(key, "a", 1)) field = 0;
+        else if (!memcmp(key, "b", 1)) field = 1;
+        break;
+    }
+    if (field < 0) {
+      return json.Error("unknown field: " + std::string(key, key_length));
+    } else if (!json.Expect(':')) {
+      return false;
+    } else if (json.Is(flatbuffers::JsonScanner::kTokenNull)) {
+      if (!json.Next()) return false;  // Ignore this field.
+    } else if (set[field]) {
+      return json.Error("field set more than once: " +
+                        std::string(key, key_length));
+    } else {
+      switch (field) {
+        case 0: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 16, &i)) return false;
+          _a = static_cast<int16_t>(i);
+          break;
+        }
+        case 1: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 8, &i)) return false;
+          _b = static_cast<int8_t>(i);
+          break;
+        }
+      }
+      set[field] = true;
+      count++;
+    }
+    if (!json.Is(',')) break;
+    if (!json.Next()) return false;
+    more = !json.Is('}');
+  }
+  if (!json.Expect('}')) return false;
+  if (count != 2)
+    return json.Error("struct: wrong number of initializers: Test");
+  Test value(_a, _b);
+  *result = value;
+  return true;
+}
+
+inline bool TestSimpleTableWithEnum::ToJson(flatbuffers::TextSink &sink, int indent) const {
+  sink += '{';
+  auto _sep = "\n";
+  if (CheckField(VT_COLOR)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("color: ", 7);
+    auto _v = GetField<int8_t>(VT_COLOR, 0);
+    switch (static_cast<int>(_v)) {
+      case 1:
+        sink.Append("Red", 3);
+        break;
+      case 2:
+        sink.Append("Green", 5);
+        break;
+      case 8:
+        sink.Append("Blue", 4);
+        break;
+      default: sink.AppendNumber(_v);
+    }
+  }
+  sink += '\n';
+  sink.Fill(indent, ' ');
+  sink += '}';
+  return true;
+}
+
+inline bool TestSimpleTableWithEnum::ParseJson(flatbuffers::JsonScanner &json,
+    flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<TestSimpleTableWithEnum> *result) {
+  int8_t _color = 0;
+  bool set[1] = {};
+  if (!json.Expect('{')) return false;
+  for (bool more = !json.Is('}'); more; ) {
+    const char *key = nullptr;
+    size_t key_length = 0;
+    if (!json.ParseFieldName(false, &key, &key_length)) return false;
+    int field = -1;
+    switch (key_length) {
+      case 5:
+        if (!memcmp(key, "color", 5)) field = 0;
+        break;
+    }
+    if (field < 0) {
+      return json.Error("unknown field: " + std::string(key, key_length));
+    } else if (!json.Expect(':')) {
+      return false;
+    } else if (json.Is(flatbuffers::JsonScanner::kTokenNull)) {
+      if (!json.Next()) return false;  // Ignore this field.
+    } else if (set[field]) {
+      return json.Error("field set more than once: " +
+                        std::string(key, key_length));
+    } else {
+      switch (field) {
+        case 0: {
+          int64_t i;
+          if (!json.ParseInteger(EnumValueColor, 8, &i)) return false;
+          _color = static_cast<int8_t>(i);
+          break;
+        }
+      }
+      set[field] = true;
+    }
+    if (!json.Is(',')) break;
+    if (!json.Next()) return false;
+    more = !json.Is('}');
+  }
+  if (!json.Expect('}')) return false;
+  TestSimpleTableWithEnumBuilder builder_(fbb);
+  if (set[0]) builder_.add_color(static_cast<Color>(_color));
+  *result = builder_.Finish();
+  return true;
+}
+
+inline bool TestSimpleTableWithEnum::ParseJson(const char *json, size_t length,
+    flatbuffers::FlatBufferBuilder &fbb, std::string *error) {
+  flatbuffers::JsonScanner scanner(json, length);
+  flatbuffers::Offset<TestSimpleTableWithEnum> root;
+  if (scanner.Next() && ParseJson(scanner, fbb, &root)) {
+    if (scanner.Is(flatbuffers::JsonScanner::kTokenEof)) {
+      fbb.Finish(root);
+      return true;
+    }
+    scanner.Error("cannot have more than one json object");
+  }
+  if (error) *error = scanner.error();
+  return false;
+}
+
+inline bool Vec3::ToJson(flatbuffers::TextSink &sink, int indent) const {
+  sink += '{';
+  {
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink.Append("x: ", 3);
+    auto _v = flatbuffers::EndianScalar(x_);
+    sink.AppendNumber(_v);
+  }
+  {
+    sink.Append(",\n", 2);
+    sink.Fill(indent + 2, ' ');
+    sink.Append("y: ", 3);
+    auto _v = flatbuffers::EndianScalar(y_);
+    sink.AppendNumber(_v);
+  }
+  {
+    sink.Append(",\n", 2);
+    sink.Fill(indent + 2, ' ');
+    sink.Append("z: ", 3);
+    auto _v = flatbuffers::EndianScalar(z_);
+    sink.AppendNumber(_v);
+  }
+  {
+    sink.Append(",\n", 2);
+    sink.Fill(indent + 2, ' ');
+    sink.Append("test1: ", 7);
+    auto _v = flatbuffers::EndianScalar(test1_);
+    sink.AppendNumber(_v);
+  }
+  {
+    sink.Append(",\n", 2);
+    sink.Fill(indent + 2, ' ');
+    sink.Append("test2: ", 7);
+    auto _v = flatbuffers::EndianScalar(test2_);
+    switch (static_cast<int>(_v)) {
+      case 1:
+        sink.Append("Red", 3);
+        break;
+      case 2:
+        sink.Append("Green", 5);
+        break;
+      case 8:
+        sink.Append("Blue", 4);
+        break;
+      default: sink.AppendNumber(_v);
+    }
+  }
+  {
+    sink.Append(",\n", 2);
+    sink.Fill(indent + 2, ' ');
+    sink.Append("test3: ", 7);
+    auto _v = &test3_;
+    if (!_v->ToJson(sink, indent + 2)) return false;
+  }
+  sink += '\n';
+  sink.Fill(indent, ' ');
+  sink += '}';
+  return true;
+}
+
+inline bool Vec3::ParseJson(flatbuffers::JsonScanner &json, Vec3 *result) {
+  float _x = 0;
+  float _y = 0;
+  float _z = 0;
+  double _test1 = 0;
+  int8_t _test2 = 0;
+  Test _test3;
+  bool set[6] = {};
+  size_t count = 0;
+  if (!json.Expect('{')) return false;
+  for (bool more = !json.Is('}'); more; ) {
+    const char *key = nullptr;
+    size_t key_length = 0;
+    if (!json.ParseFieldName(false, &key, &key_length)) return false;
+    int field = -1;
+    switch (key_length) {
+      case 1:
+        if (!memcmp(key, "x", 1)) field = 0;
+        else if (!memcmp(key, "y", 1)) field = 1;
+        else if (!memcmp(key, "z", 1)) field = 2;
+        break;
+      case 5:
+        if (!memcmp(key, "test1", 5)) field = 3;
+        else if (!memcmp(key, "test2", 5)) field = 4;
+        else if (!memcmp(key, "test3", 5)) field = 5;
+        break;
+    }
+    if (field < 0) {
+      return json.Error("unknown field: " + std::string(key, key_length));
+    } else if (!json.Expect(':')) {
+      return false;
+    } else if (json.Is(flatbuffers::JsonScanner::kTokenNull)) {
+      if (!json.Next()) return false;  // Ignore this field.
+    } else if (set[field]) {
+      return json.Error("field set more than once: " +
+                        std::string(key, key_length));
+    } else {
+      switch (field) {
+        case 0: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _x = static_cast<float>(d);
+          break;
+        }
+        case 1: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _y = static_cast<float>(d);
+          break;
+        }
+        case 2: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _z = static_cast<float>(d);
+          break;
+        }
+        case 3: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _test1 = d;
+          break;
+        }
+        case 4: {
+          int64_t i;
+          if (!json.ParseInteger(EnumValueColor, 8, &i)) return false;
+          _test2 = static_cast<int8_t>(i);
+          break;
+        }
+        case 5: {
+          if (!Test::ParseJson(json, &_test3)) return false;
+          break;
+        }
+      }
+      set[field] = true;
+      count++;
+    }
+    if (!json.Is(',')) break;
+    if (!json.Next()) return false;
+    more = !json.Is('}');
+  }
+  if (!json.Expect('}')) return false;
+  if (count != 6)
+    return json.Error("struct: wrong number of initializers: Vec3");
+  Vec3 value(_x, _y, _z, _test1, static_cast<Color>(_test2), _test3);
+  *result = value;
+  return true;
+}
+
+inline bool Stat::ToJson(flatbuffers::TextSink &sink, int indent) const {
+  sink += '{';
+  auto _sep = "\n";
+  if (CheckField(VT_ID)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("id: ", 4);
+    auto _v = GetPointer<const flatbuffers::String *>(VT_ID);
+    if (!flatbuffers::EscapeJsonString(_v->c_str(), _v->size(), false, &sink)) return false;
+  }
+  if (CheckField(VT_VAL)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("val: ", 5);
+    auto _v = GetField<int64_t>(VT_VAL, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_COUNT)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("count: ", 7);
+    auto _v = GetField<uint16_t>(VT_COUNT, 0);
+    sink.AppendNumber(_v);
+  }
+  sink += '\n';
+  sink.Fill(indent, ' ');
+  sink += '}';
+  return true;
+}
+
+inline bool Stat::ParseJson(flatbuffers::JsonScanner &json,
+    flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Stat> *result) {
+  flatbuffers::Offset<flatbuffers::String> _id;
+  int64_t _val = 0;
+  uint16_t _count = 0;
+  bool set[3] = {};
+  if (!json.Expect('{')) return false;
+  for (bool more = !json.Is('}'); more; ) {
+    const char *key = nullptr;
+    size_t key_length = 0;
+    if (!json.ParseFieldName(false, &key, &key_length)) return false;
+    int field = -1;
+    switch (key_length) {
+      case 2:
+        if (!memcmp(key, "id", 2)) field = 0;
+        break;
+      case 3:
+        if (!memcmp(key, "val", 3)) field = 1;
+        break;
+      case 5:
+        if (!memcmp(key, "count", 5)) field = 2;
+        break;
+    }
+    if (field < 0) {
+      return json.Error("unknown field: " + std::string(key, key_length));
+    } else if (!json.Expect(':')) {
+      return false;
+    } else if (json.Is(flatbuffers::JsonScanner::kTokenNull)) {
+      if (!json.Next()) return false;  // Ignore this field.
+    } else if (set[field]) {
+      return json.Error("field set more than once: " +
+                        std::string(key, key_length));
+    } else {
+      switch (field) {
+        case 0: {
+          if (!json.ParseString(false, fbb, &_id)) return false;
+          break;
+        }
+        case 1: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 64, &i)) return false;
+          _val = static_cast<int64_t>(i);
+          break;
+        }
+        case 2: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 16, &i)) return false;
+          _count = static_cast<uint16_t>(i);
+          break;
+        }
+      }
+      set[field] = true;
+    }
+    if (!json.Is(',')) break;
+    if (!json.Next()) return false;
+    more = !json.Is('}');
+  }
+  if (!json.Expect('}')) return false;
+  StatBuilder builder_(fbb);
+  if (set[1]) builder_.add_val(_val);
+  if (set[0]) builder_.add_id(_id);
+  if (set[2]) builder_.add_count(_count);
+  *result = builder_.Finish();
+  return true;
+}
+
+inline bool Stat::ParseJson(const char *json, size_t length,
+    flatbuffers::FlatBufferBuilder &fbb, std::string *error) {
+  flatbuffers::JsonScanner scanner(json, length);
+  flatbuffers::Offset<Stat> root;
+  if (scanner.Next() && ParseJson(scanner, fbb, &root)) {
+    if (scanner.Is(flatbuffers::JsonScanner::kTokenEof)) {
+      fbb.Finish(root);
+      return true;
+    }
+    scanner.Error("cannot have more than one json object");
+  }
+  if (error) *error = scanner.error();
+  return false;
+}
+
+inline bool Monster::ToJson(flatbuffers::TextSink &sink, int indent) const {
+  sink += '{';
+  auto _sep = "\n";
+  if (CheckField(VT_POS)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("pos: ", 5);
+    auto _v = GetStruct<const Vec3 *>(VT_POS);
+    if (!_v->ToJson(sink, indent + 2)) return false;
+  }
+  if (CheckField(VT_MANA)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("mana: ", 6);
+    auto _v = GetField<int16_t>(VT_MANA, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_HP)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("hp: ", 4);
+    auto _v = GetField<int16_t>(VT_HP, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_NAME)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("name: ", 6);
+    auto _v = GetPointer<const flatbuffers::String *>(VT_NAME);
+    if (!flatbuffers::EscapeJsonString(_v->c_str(), _v->size(), false, &sink)) return false;
+  }
+  if (CheckField(12)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("friendly: ", 10);
+    auto _v = GetField<uint8_t>(12, 0);
+    sink += _v != 0 ? "true" : "false";
+  }
+  if (CheckField(VT_INVENTORY)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("inventory: ", 11);
+    auto _v = GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_INVENTORY);
+    sink.Append("[\n", 2);
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      if (_i) sink += ",\n";
+      sink.Fill(indent + 4, ' ');
+      auto _e = _v->Get(_i);
+      sink.AppendNumber(_e);
+    }
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink += ']';
+  }
+  if (CheckField(VT_COLOR)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("color: ", 7);
+    auto _v = GetField<int8_t>(VT_COLOR, 0);
+    switch (static_cast<int>(_v)) {
+      case 1:
+        sink.Append("Red", 3);
+        break;
+      case 2:
+        sink.Append("Green", 5);
+        break;
+      case 8:
+        sink.Append("Blue", 4);
+        break;
+      default: sink.AppendNumber(_v);
+    }
+  }
+  if (CheckField(VT_TEST_TYPE)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("test_type: ", 11);
+    auto _v = GetField<uint8_t>(VT_TEST_TYPE, 0);
+    switch (static_cast<int>(_v)) {
+      case 1:
+        sink.Append("Monster", 7);
+        break;
+      case 2:
+        sink.Append("TestSimpleTableWithEnum", 23);
+        break;
+      case 3:
+        sink.Append("MyGame_Example2_Monster", 23);
+        break;
+      default: sink.AppendNumber(_v);
+    }
+  }
+  if (CheckField(VT_TEST)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("test: ", 6);
+    auto _v = GetPointer<const void *>(VT_TEST);
+    switch (GetField<uint8_t>(VT_TEST_TYPE, 0)) {
+      case 1:
+        if (!static_cast<const Monster *>(_v)->ToJson(sink, indent + 2)) return false;
+        break;
+      case 2:
+        if (!static_cast<const TestSimpleTableWithEnum *>(_v)->ToJson(sink, indent + 2)) return false;
+        break;
+      case 3:
+        if (!static_cast<const MyGame::Example2::Monster *>(_v)->ToJson(sink, indent + 2)) return false;
+        break;
+      default: return false;
+    }
+  }
+  if (CheckField(VT_TEST4)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("test4: ", 7);
+    auto _v = GetPointer<const flatbuffers::Vector<const Test *> *>(VT_TEST4);
+    sink.Append("[\n", 2);
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      if (_i) sink += ",\n";
+      sink.Fill(indent + 4, ' ');
+      auto _e = _v->Get(_i);
+      if (!_e->ToJson(sink, indent + 4)) return false;
+    }
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink += ']';
+  }
+  if (CheckField(VT_TESTARRAYOFSTRING)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testarrayofstring: ", 19);
+    auto _v = GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_TESTARRAYOFSTRING);
+    sink.Append("[\n", 2);
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      if (_i) sink += ",\n";
+      sink.Fill(indent + 4, ' ');
+      auto _e = _v->Get(_i);
+      if (!flatbuffers::EscapeJsonString(_e->c_str(), _e->size(), false, &sink)) return false;
+    }
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink += ']';
+  }
+  if (CheckField(VT_TESTARRAYOFTABLES)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testarrayoftables: ", 19);
+    auto _v = GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Monster>> *>(VT_TESTARRAYOFTABLES);
+    sink.Append("[\n", 2);
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      if (_i) sink += ",\n";
+      sink.Fill(indent + 4, ' ');
+      auto _e = _v->Get(_i);
+      if (!_e->ToJson(sink, indent + 4)) return false;
+    }
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink += ']';
+  }
+  if (CheckField(VT_ENEMY)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("enemy: ", 7);
+    auto _v = GetPointer<const Monster *>(VT_ENEMY);
+    if (!_v->ToJson(sink, indent + 2)) return false;
+  }
+  if (CheckField(VT_TESTNESTEDFLATBUFFER)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testnestedflatbuffer: ", 22);
+    auto _v = GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_TESTNESTEDFLATBUFFER);
+    sink.Append("[\n", 2);
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      if (_i) sink += ",\n";
+      sink.Fill(indent + 4, ' ');
+      auto _e = _v->Get(_i);
+      sink.AppendNumber(_e);
+    }
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink += ']';
+  }
+  if (CheckField(VT_TESTEMPTY)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testempty: ", 11);
+    auto _v = GetPointer<const Stat *>(VT_TESTEMPTY);
+    if (!_v->ToJson(sink, indent + 2)) return false;
+  }
+  if (CheckField(VT_TESTBOOL)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testbool: ", 10);
+    auto _v = GetField<uint8_t>(VT_TESTBOOL, 0);
+    sink += _v != 0 ? "true" : "false";
+  }
+  if (CheckField(VT_TESTHASHS32_FNV1)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashs32_fnv1: ", 18);
+    auto _v = GetField<int32_t>(VT_TESTHASHS32_FNV1, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTHASHU32_FNV1)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashu32_fnv1: ", 18);
+    auto _v = GetField<uint32_t>(VT_TESTHASHU32_FNV1, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTHASHS64_FNV1)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashs64_fnv1: ", 18);
+    auto _v = GetField<int64_t>(VT_TESTHASHS64_FNV1, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTHASHU64_FNV1)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashu64_fnv1: ", 18);
+    auto _v = GetField<uint64_t>(VT_TESTHASHU64_FNV1, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTHASHS32_FNV1A)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashs32_fnv1a: ", 19);
+    auto _v = GetField<int32_t>(VT_TESTHASHS32_FNV1A, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTHASHU32_FNV1A)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashu32_fnv1a: ", 19);
+    auto _v = GetField<uint32_t>(VT_TESTHASHU32_FNV1A, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTHASHS64_FNV1A)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashs64_fnv1a: ", 19);
+    auto _v = GetField<int64_t>(VT_TESTHASHS64_FNV1A, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTHASHU64_FNV1A)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testhashu64_fnv1a: ", 19);
+    auto _v = GetField<uint64_t>(VT_TESTHASHU64_FNV1A, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTARRAYOFBOOLS)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testarrayofbools: ", 18);
+    auto _v = GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_TESTARRAYOFBOOLS);
+    sink.Append("[\n", 2);
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      if (_i) sink += ",\n";
+      sink.Fill(indent + 4, ' ');
+      auto _e = _v->Get(_i);
+      sink += _e != 0 ? "true" : "false";
+    }
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink += ']';
+  }
+  if (CheckField(VT_TESTF)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testf: ", 7);
+    auto _v = GetField<float>(VT_TESTF, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTF2)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testf2: ", 8);
+    auto _v = GetField<float>(VT_TESTF2, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTF3)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testf3: ", 8);
+    auto _v = GetField<float>(VT_TESTF3, 0);
+    sink.AppendNumber(_v);
+  }
+  if (CheckField(VT_TESTARRAYOFSTRING2)) {
+    sink += _sep;
+    _sep = ",\n";
+    sink.Fill(indent + 2, ' ');
+    sink.Append("testarrayofstring2: ", 20);
+    auto _v = GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_TESTARRAYOFSTRING2);
+    sink.Append("[\n", 2);
+    for (flatbuffers::uoffset_t _i = 0; _i < _v->size(); _i++) {
+      if (_i) sink += ",\n";
+      sink.Fill(indent + 4, ' ');
+      auto _e = _v->Get(_i);
+      if (!flatbuffers::EscapeJsonString(_e->c_str(), _e->size(), false, &sink)) return false;
+    }
+    sink += '\n';
+    sink.Fill(indent + 2, ' ');
+    sink += ']';
+  }
+  sink += '\n';
+  sink.Fill(indent, ' ');
+  sink += '}';
+  return true;
+}
+
+inline bool Monster::ParseJson(flatbuffers::JsonScanner &json,
+    flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Monster> *result) {
+  Vec3 _pos;
+  int16_t _mana = 0;
+  int16_t _hp = 0;
+  flatbuffers::Offset<flatbuffers::String> _name;
+  uint8_t _friendly = 0;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> _inventory;
+  int8_t _color = 0;
+  uint8_t _test_type = 0;
+  flatbuffers::Offset<void> _test;
+  flatbuffers::Offset<flatbuffers::Vector<const Test *>> _test4;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> _testarrayofstring;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Monster>>> _testarrayoftables;
+  flatbuffers::Offset<Monster> _enemy;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> _testnestedflatbuffer;
+  flatbuffers::Offset<Stat> _testempty;
+  uint8_t _testbool = 0;
+  int32_t _testhashs32_fnv1 = 0;
+  uint32_t _testhashu32_fnv1 = 0;
+  int64_t _testhashs64_fnv1 = 0;
+  uint64_t _testhashu64_fnv1 = 0;
+  int32_t _testhashs32_fnv1a = 0;
+  uint32_t _testhashu32_fnv1a = 0;
+  int64_t _testhashs64_fnv1a = 0;
+  uint64_t _testhashu64_fnv1a = 0;
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> _testarrayofbools;
+  float _testf = 0;
+  float _testf2 = 0;
+  float _testf3 = 0;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> _testarrayofstring2;
+  bool set[29] = {};
+  if (!json.Expect('{')) return false;
+  for (bool more = !json.Is('}'); more; ) {
+    const char *key = nullptr;
+    size_t key_length = 0;
+    if (!json.ParseFieldName(false, &key, &key_length)) return false;
+    int field = -1;
+    switch (key_length) {
+      case 2:
+        if (!memcmp(key, "hp", 2)) field = 2;
+        break;
+      case 3:
+        if (!memcmp(key, "pos", 3)) field = 0;
+        break;
+      case 4:
+        if (!memcmp(key, "mana", 4)) field = 1;
+        else if (!memcmp(key, "name", 4)) field = 3;
+        else if (!memcmp(key, "test", 4)) field = 8;
+        break;
+      case 5:
+        if (!memcmp(key, "color", 5)) field = 6;
+        else if (!memcmp(key, "test4", 5)) field = 9;
+        else if (!memcmp(key, "enemy", 5)) field = 12;
+        else if (!memcmp(key, "testf", 5)) field = 25;
+        break;
+      case 6:
+        if (!memcmp(key, "testf2", 6)) field = 26;
+        else if (!memcmp(key, "testf3", 6)) field = 27;
+        break;
+      case 8:
+        if (!memcmp(key, "friendly", 8)) field = 4;
+        else if (!memcmp(key, "testbool", 8)) field = 15;
+        break;
+      case 9:
+        if (!memcmp(key, "inventory", 9)) field = 5;
+        else if (!memcmp(key, "test_type", 9)) field = 7;
+        else if (!memcmp(key, "testempty", 9)) field = 14;
+        break;
+      case 16:
+        if (!memcmp(key, "testhashs32_fnv1", 16)) field = 16;
+        else if (!memcmp(key, "testhashu32_fnv1", 16)) field = 17;
+        else if (!memcmp(key, "testhashs64_fnv1", 16)) field = 18;
+        else if (!memcmp(key, "testhashu64_fnv1", 16)) field = 19;
+        else if (!memcmp(key, "testarrayofbools", 16)) field = 24;
+        break;
+      case 17:
+        if (!memcmp(key, "testarrayofstring", 17)) field = 10;
+        else if (!memcmp(key, "testarrayoftables", 17)) field = 11;
+        else if (!memcmp(key, "testhashs32_fnv1a", 17)) field = 20;
+        else if (!memcmp(key, "testhashu32_fnv1a", 17)) field = 21;
+        else if (!memcmp(key, "testhashs64_fnv1a", 17)) field = 22;
+        else if (!memcmp(key, "testhashu64_fnv1a", 17)) field = 23;
+        break;
+      case 18:
+        if (!memcmp(key, "testarrayofstring2", 18)) field = 28;
+        break;
+      case 20:
+        if (!memcmp(key, "testnestedflatbuffer", 20)) field = 13;
+        break;
+    }
+    if (field < 0) {
+      return json.Error("unknown field: " + std::string(key, key_length));
+    } else if (!json.Expect(':')) {
+      return false;
+    } else if (json.Is(flatbuffers::JsonScanner::kTokenNull)) {
+      if (!json.Next()) return false;  // Ignore this field.
+    } else if (set[field]) {
+      return json.Error("field set more than once: " +
+                        std::string(key, key_length));
+    } else {
+      switch (field) {
+        case 0: {
+          if (!Vec3::ParseJson(json, &_pos)) return false;
+          break;
+        }
+        case 1: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 16, &i)) return false;
+          _mana = static_cast<int16_t>(i);
+          break;
+        }
+        case 2: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 16, &i)) return false;
+          _hp = static_cast<int16_t>(i);
+          break;
+        }
+        case 3: {
+          if (!json.ParseString(false, fbb, &_name)) return false;
+          break;
+        }
+        case 4: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 64, &i)) return false;
+          _friendly = i != 0;
+          break;
+        }
+        case 5: {
+          std::vector<uint8_t> v;
+          if (!json.Expect('[')) return false;
+          for (bool elements = !json.Is(']'); elements; ) {
+            uint8_t e;
+            int64_t i;
+            if (!json.ParseInteger(nullptr, 8, &i)) return false;
+            e = static_cast<uint8_t>(i);
+            v.push_back(e);
+            if (!json.Is(',')) break;
+            if (!json.Next()) return false;
+            elements = !json.Is(']');
+          }
+          if (!json.Expect(']')) return false;
+          _inventory = fbb.CreateVector(v);
+          break;
+        }
+        case 6: {
+          int64_t i;
+          if (!json.ParseInteger(EnumValueColor, 8, &i)) return false;
+          _color = static_cast<int8_t>(i);
+          break;
+        }
+        case 7: {
+          int64_t i;
+          if (!json.ParseInteger(EnumValueAny, 8, &i)) return false;
+          _test_type = static_cast<uint8_t>(i);
+          break;
+        }
+        case 8: {
+          auto type = _test_type;
+          auto after = json.Save();
+          if (!set[7]) {
+            size_t value;
+            if (!json.RecordValue(&value)) return false;
+            after = json.Save();
+            if (!json.Expect(',') ||
+                !json.ParseFieldName(false, &key, &key_length))
+              return false;
+            if (key_length != 9 || memcmp(key, "test_type", key_length))
+              return json.Error("missing type field after this union value: test_type");
+            if (!json.Expect(':')) return false;
+            int64_t i;
+            if (!json.ParseInteger(EnumValueAny, 8, &i)) return false;
+            type = static_cast<uint8_t>(i);
+            if (!json.Replay(value)) return false;
+          }
+          switch (type) {
+            case 1: {
+              flatbuffers::Offset<Monster> table;
+              if (!Monster::ParseJson(json, fbb, &table)) return false;
+              _test = table.Union();
+              break;
+            }
+            case 2: {
+              flatbuffers::Offset<TestSimpleTableWithEnum> table;
+              if (!TestSimpleTableWithEnum::ParseJson(json, fbb, &table)) return false;
+              _test = table.Union();
+              break;
+            }
+            case 3: {
+              flatbuffers::Offset<MyGame::Example2::Monster> table;
+              if (!MyGame::Example2::Monster::ParseJson(json, fbb, &table)) return false;
+              _test = table.Union();
+              break;
+            }
+            default:
+              return json.Error("illegal type id for: test");
+          }
+          if (!set[7]) json.Restore(after);
+          break;
+        }
+        case 9: {
+          std::vector<Test> v;
+          if (!json.Expect('[')) return false;
+          for (bool elements = !json.Is(']'); elements; ) {
+            Test e;
+            if (!Test::ParseJson(json, &e)) return false;
+            v.push_back(e);
+            if (!json.Is(',')) break;
+            if (!json.Next()) return false;
+            elements = !json.Is(']');
+          }
+          if (!json.Expect(']')) return false;
+          _test4 = fbb.CreateVectorOfStructs(v);
+          break;
+        }
+        case 10: {
+          std::vector<flatbuffers::Offset<flatbuffers::String>> v;
+          if (!json.Expect('[')) return false;
+          for (bool elements = !json.Is(']'); elements; ) {
+            flatbuffers::Offset<flatbuffers::String> e;
+            if (!json.ParseString(false, fbb, &e)) return false;
+            v.push_back(e);
+            if (!json.Is(',')) break;
+            if (!json.Next()) return false;
+            elements = !json.Is(']');
+          }
+          if (!json.Expect(']')) return false;
+          _testarrayofstring = fbb.CreateVector(v);
+          break;
+        }
+        case 11: {
+          std::vector<flatbuffers::Offset<Monster>> v;
+          if (!json.Expect('[')) return false;
+          for (bool elements = !json.Is(']'); elements; ) {
+            flatbuffers::Offset<Monster> e;
+            if (!Monster::ParseJson(json, fbb, &e)) return false;
+            v.push_back(e);
+            if (!json.Is(',')) break;
+            if (!json.Next()) return false;
+            elements = !json.Is(']');
+          }
+          if (!json.Expect(']')) return false;
+          _testarrayoftables = fbb.CreateVector(v);
+          break;
+        }
+        case 12: {
+          if (!Monster::ParseJson(json, fbb, &_enemy)) return false;
+          break;
+        }
+        case 13: {
+          std::vector<uint8_t> v;
+          if (!json.Expect('[')) return false;
+          for (bool elements = !json.Is(']'); elements; ) {
+            uint8_t e;
+            int64_t i;
+            if (!json.ParseInteger(nullptr, 8, &i)) return false;
+            e = static_cast<uint8_t>(i);
+            v.push_back(e);
+            if (!json.Is(',')) break;
+            if (!json.Next()) return false;
+            elements = !json.Is(']');
+          }
+          if (!json.Expect(']')) return false;
+          _testnestedflatbuffer = fbb.CreateVector(v);
+          break;
+        }
+        case 14: {
+          if (!Stat::ParseJson(json, fbb, &_testempty)) return false;
+          break;
+        }
+        case 15: {
+          int64_t i;
+          if (!json.ParseInteger(nullptr, 64, &i)) return false;
+          _testbool = i != 0;
+          break;
+        }
+        case 16: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1<uint32_t>, 32, &i)) return false;
+          _testhashs32_fnv1 = static_cast<int32_t>(i);
+          break;
+        }
+        case 17: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1<uint32_t>, 32, &i)) return false;
+          _testhashu32_fnv1 = static_cast<uint32_t>(i);
+          break;
+        }
+        case 18: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1<uint64_t>, 64, &i)) return false;
+          _testhashs64_fnv1 = static_cast<int64_t>(i);
+          break;
+        }
+        case 19: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1<uint64_t>, 64, &i)) return false;
+          _testhashu64_fnv1 = static_cast<uint64_t>(i);
+          break;
+        }
+        case 20: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1a<uint32_t>, 32, &i)) return false;
+          _testhashs32_fnv1a = static_cast<int32_t>(i);
+          break;
+        }
+        case 21: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1a<uint32_t>, 32, &i)) return false;
+          _testhashu32_fnv1a = static_cast<uint32_t>(i);
+          break;
+        }
+        case 22: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1a<uint64_t>, 64, &i)) return false;
+          _testhashs64_fnv1a = static_cast<int64_t>(i);
+          break;
+        }
+        case 23: {
+          int64_t i;
+          if (!json.ParseHash(flatbuffers::HashFnv1a<uint64_t>, 64, &i)) return false;
+          _testhashu64_fnv1a = static_cast<uint64_t>(i);
+          break;
+        }
+        case 24: {
+          std::vector<uint8_t> v;
+          if (!json.Expect('[')) return false;
+          for (bool elements = !json.Is(']'); elements; ) {
+            uint8_t e;
+            int64_t i;
+            if (!json.ParseInteger(nullptr, 64, &i)) return false;
+            e = i != 0;
+            v.push_back(e);
+            if (!json.Is(',')) break;
+            if (!json.Next()) return false;
+            elements = !json.Is(']');
+          }
+          if (!json.Expect(']')) return false;
+          _testarrayofbools = fbb.CreateVector(v);
+          break;
+        }
+        case 25: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _testf = static_cast<float>(d);
+          break;
+        }
+        case 26: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _testf2 = static_cast<float>(d);
+          break;
+        }
+        case 27: {
+          double d;
+          if (!json.ParseFloat(&d)) return false;
+          _testf3 = static_cast<float>(d);
+          break;
+        }
+        case 28: {
+          std::vector<flatbuffers::Offset<flatbuffers::String>> v;
+          if (!json.Expect('[')) return false;
+          for (bool elements = !json.Is(']'); elements; ) {
+            flatbuffers::Offset<flatbuffers::String> e;
+            if (!json.ParseString(false, fbb, &e)) return false;
+            v.push_back(e);
+            if (!json.Is(',')) break;
+            if (!json.Next()) return false;
+            elements = !json.Is(']');
+          }
+          if (!json.Expect(']')) return false;
+          _testarrayofstring2 = fbb.CreateVector(v);
+          break;
+        }
+      }
+      set[field] = true;
+    }
+    if (!json.Is(',')) break;
+    if (!json.Next()) return false;
+    more = !json.Is('}');
+  }
+  if (!json.Expect('}')) return false;
+  if (!set[3])
+    return json.Error("missing required field: name");
+  MonsterBuilder builder_(fbb);
+  if (set[23]) builder_.add_testhashu64_fnv1a(_testhashu64_fnv1a);
+  if (set[22]) builder_.add_testhashs64_fnv1a(_testhashs64_fnv1a);
+  if (set[19]) builder_.add_testhashu64_fnv1(_testhashu64_fnv1);
+  if (set[18]) builder_.add_testhashs64_fnv1(_testhashs64_fnv1);
+  if (set[28]) builder_.add_testarrayofstring2(_testarrayofstring2);
+  if (set[27]) builder_.add_testf3(_testf3);
+  if (set[26]) builder_.add_testf2(_testf2);
+  if (set[25]) builder_.add_testf(_testf);
+  if (set[24]) builder_.add_testarrayofbools(_testarrayofbools);
+  if (set[21]) builder_.add_testhashu32_fnv1a(_testhashu32_fnv1a);
+  if (set[20]) builder_.add_testhashs32_fnv1a(_testhashs32_fnv1a);
+  if (set[17]) builder_.add_testhashu32_fnv1(_testhashu32_fnv1);
+  if (set[16]) builder_.add_testhashs32_fnv1(_testhashs32_fnv1);
+  if (set[14]) builder_.add_testempty(_testempty);
+  if (set[13]) builder_.add_testnestedflatbuffer(_testnestedflatbuffer);
+  if (set[12]) builder_.add_enemy(_enemy);
+  if (set[11]) builder_.add_testarrayoftables(_testarrayoftables);
+  if (set[10]) builder_.add_testarrayofstring(_testarrayofstring);
+  if (set[9]) builder_.add_test4(_test4);
+  if (set[8]) builder_.add_test(_test);
+  if (set[5]) builder_.add_inventory(_inventory);
+  if (set[3]) builder_.add_name(_name);
+  if (set[0]) builder_.add_pos(&_pos);
+  if (set[2]) builder_.add_hp(_hp);
+  if (set[1]) builder_.add_mana(_mana);
+  if (set[15]) builder_.add_testbool(_testbool != 0);
+  if (set[7]) builder_.add_test_type(static_cast<Any>(_test_type));
+  if (set[6]) builder_.add_color(static_cast<Color>(_color));
+  if (set[4]) builder_.fbb_.AddElement<uint8_t>(12, _friendly, 0);
+  *result = builder_.Finish();
+  return true;
+}
+
+inline bool Monster::ParseJson(const char *json, size_t length,
+    flatbuffers::FlatBufferBuilder &fbb, std::string *error) {
+  flatbuffers::JsonScanner scanner(json, length);
+  flatbuffers::Offset<Monster> root;
+  if (scanner.Next() && ParseJson(scanner, fbb, &root)) {
+    if (scanner.Is(flatbuffers::JsonScanner::kTokenEof)) {
+      fbb.Finish(root, "MONS");
+      return true;
+    }
+    scanner.Error("cannot have more than one json object");
+  }
+  if (error) *error = scanner.error();
+  return false;
+}
+
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, Any type) {
   switch (type) {
     case Any_NONE: return true;
@@ -35,6 +35,7 @@ MANUALLY_ALIGNED_STRUCT(4) StructInNestedNS FLATBUFFERS_FINAL_CLASS {
  public:
   StructInNestedNS() { memset(this, 0, sizeof(StructInNestedNS)); }
   StructInNestedNS(const StructInNestedNS &_o) { memcpy(this, &_o, sizeof(StructInNestedNS)); }
+  StructInNestedNS &operator=(const StructInNestedNS &) = default;
   StructInNestedNS(int32_t _a, int32_t _b)
     : a_(flatbuffers::EndianScalar(_a)), b_(flatbuffers::EndianScalar(_b)) { }
 
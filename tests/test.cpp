@@ -19,9 +19,12 @@
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/json.h"
+#include "flatbuffers/thread_pool.h"
 #include "flatbuffers/util.h"
 
 #include "monster_test_generated.h"
+#include "defaults_json_test_generated.h"
 #include "namespace_test/namespace_test1_generated.h"
 #include "namespace_test/namespace_test2_generated.h"
 
@@ -383,6 +386,274 @@ void ObjectFlatBuffersTest(uint8_t *flatbuf) {
   TEST_EQ(tests[1].b(), 40);
 }
 
+// Recycling builders and their memory across many messages.
+void BuilderReuseTest() {
+  auto build = [](flatbuffers::FlatBufferBuilder &fbb, const char *name) {
+    fbb.Finish(CreateMonster(fbb, nullptr, 0, 0, fbb.CreateString(name)));
+    return GetMonster(fbb.GetBufferPointer());
+  };
+
+  // Handing a released buffer back to the builder reuses its memory.
+  flatbuffers::FlatBufferBuilder fbb;
+  build(fbb, "Fred");
+  auto size = fbb.GetSize();
+  auto released = fbb.ReleaseBufferPointer();
+  auto start = released.get() + size;
+  TEST_EQ(fbb.Reset(std::move(released)), true);
+  TEST_EQ(released.get() == nullptr, true);
+  TEST_EQ_STR(build(fbb, "Barney")->name()->c_str(), "Barney");
+  TEST_EQ(fbb.GetBufferPointer() + fbb.GetSize() == start, true);
+
+  // Buffers from a builder with a different allocator can't be reused.
+  flatbuffers::pooled_allocator pool(256, 2);
+  flatbuffers::FlatBufferBuilder other(256, &pool);
+  build(other, "Wilma");
+  TEST_EQ(fbb.Reset(other.ReleaseBufferPointer()), false);
+  TEST_EQ_STR(build(fbb, "Fred")->name()->c_str(), "Fred");
+
+  // A pool recycles buffers, and sizes them to the largest one seen so far.
+  pool.reserve(4);
+  TEST_EQ(pool.cached(), 2U);
+  other.Clear();
+  TEST_EQ(pool.cached(), 1U);
+  other.Finish(CreateMonster(other, nullptr, 0, 0,
+                             other.CreateString(std::string(1000, 'x'))));
+  TEST_EQ(pool.high_water_mark() > 1000, true);
+  TEST_EQ(pool.cached(), 0U);  // Buffers that are now too small got dropped.
+  other.ReleaseBufferPointer().reset();
+  TEST_EQ(pool.cached(), 1U);
+  flatbuffers::FlatBufferBuilder sized(
+    static_cast<flatbuffers::uoffset_t>(pool.high_water_mark()), &pool);
+  TEST_EQ(pool.cached(), 0U);
+  auto data = sized.GetCurrentBufferPointer();
+  sized.Finish(CreateMonster(sized, nullptr, 0, 0,
+                             sized.CreateString(std::string(1000, 'y'))));
+  TEST_EQ(sized.GetBufferPointer() == data - sized.GetSize(), true);
+}
+
+// Tables with the same layout must share a vtable, however many layouts
+// there are.
+void VTableDedupTest() {
+  using flatbuffers::voffset_t;
+  // Builds a table with only field `field` set, giving each field its own
+  // vtable layout. Returns the location of the vtable used.
+  auto table = [](flatbuffers::FlatBufferBuilder &fbb, voffset_t field) {
+    fbb.Align(sizeof(int32_t));  // Such that the object size doesn't vary.
+    auto start = fbb.StartTable();
+    fbb.AddElement<int32_t>(flatbuffers::FieldIndexToOffset(field), 1, 0);
+    auto off = fbb.EndTable(start, static_cast<voffset_t>(field + 1));
+    auto table_ptr = fbb.GetCurrentBufferPointer() + fbb.GetSize() - off;
+    return off + flatbuffers::ReadScalar<flatbuffers::soffset_t>(table_ptr);
+  };
+
+  const voffset_t num_layouts = 200;
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::uoffset_t> vtables;
+  for (voffset_t i = 0; i < num_layouts; i++)
+    vtables.push_back(table(fbb, i));
+  for (voffset_t i = 0; i < num_layouts; i++)
+    TEST_EQ(table(fbb, i), vtables[i]);
+  TEST_EQ(fbb.GetVTableCacheMisses(), num_layouts);
+  TEST_EQ(fbb.GetVTableCacheHits(), num_layouts);
+
+  // With a limit, only the first few layouts get shared.
+  flatbuffers::FlatBufferBuilder capped;
+  capped.SetVTableCacheLimit(2);
+  auto first = table(capped, 0);
+  auto third = table(capped, 2);
+  table(capped, 1);
+  table(capped, 3);
+  TEST_EQ(table(capped, 0), first);
+  TEST_EQ(table(capped, 2), third);
+  TEST_EQ(table(capped, 1) == table(capped, 1), false);
+  TEST_EQ(capped.GetVTableCacheHits(), 2U);
+  TEST_EQ(capped.GetVTableCacheMisses(), 6U);
+}
+
+void SharedStringTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  for (int pass = 0; pass < 2; pass++) {
+    // Enough strings to make the pool grow a few times.
+    std::vector<flatbuffers::uoffset_t> offsets;
+    auto str = [](int i) { return flatbuffers::NumToString(i); };
+    for (int i = 0; i < 300; i++)
+      offsets.push_back(fbb.CreateSharedString(str(i)).o);
+    auto size = fbb.GetSize();
+    for (int i = 0; i < 300; i++)
+      TEST_EQ(fbb.CreateSharedString(str(i)).o, offsets[i]);
+    TEST_EQ(fbb.GetSize(), size);  // Nothing was written.
+    // Strings only match if their contents, including length, are the same.
+    auto a = fbb.CreateSharedString("a\0b", 3);
+    TEST_EQ(fbb.CreateSharedString("a\0c", 3).o == a.o, false);
+    TEST_EQ(fbb.CreateSharedString("a", 1).o == a.o, false);
+    TEST_EQ(fbb.CreateSharedString("a\0b", 3).o, a.o);
+    // The pool must forget all strings of the previous buffer.
+    fbb.Clear();
+  }
+}
+
+// Vectors written in bulk must be identical to pushing elements one by one.
+void BulkVectorTest() {
+  flatbuffers::FlatBufferBuilder bulk, single;
+  auto strings = [](flatbuffers::FlatBufferBuilder &fbb) {
+    std::vector<flatbuffers::Offset<flatbuffers::String>> offsets;
+    offsets.push_back(fbb.CreateString("a"));
+    offsets.push_back(fbb.CreateString("bc"));
+    return offsets;
+  };
+  std::vector<double> doubles;
+  doubles.push_back(1.5);
+  doubles.push_back(-2);
+  std::vector<int16_t> shorts(3, 7);
+  std::vector<bool> bools(5, true);
+  bools[1] = false;
+
+  bulk.CreateVector(shorts);
+  bulk.CreateVector(doubles);
+  bulk.CreateVector(bools);
+  bulk.CreateVector(strings(bulk));
+  bulk.CreateVector(std::vector<double>());
+
+  single.StartVector(shorts.size(), sizeof(int16_t));
+  for (auto i = shorts.size(); i > 0; ) single.PushElement(shorts[--i]);
+  single.EndVector(shorts.size());
+  single.StartVector(doubles.size(), sizeof(double));
+  for (auto i = doubles.size(); i > 0; ) single.PushElement(doubles[--i]);
+  single.EndVector(doubles.size());
+  single.StartVector(bools.size(), sizeof(uint8_t));
+  for (auto i = bools.size(); i > 0; )
+    single.PushElement(static_cast<uint8_t>(bools[--i]));
+  single.EndVector(bools.size());
+  auto offsets = strings(single);
+  single.StartVector(offsets.size(), sizeof(flatbuffers::uoffset_t));
+  for (auto i = offsets.size(); i > 0; ) single.PushElement(offsets[--i]);
+  single.EndVector(offsets.size());
+  single.StartVector(0, sizeof(double));
+  single.EndVector(0);
+
+  TEST_EQ(bulk.GetSize(), single.GetSize());
+  TEST_EQ(memcmp(bulk.GetCurrentBufferPointer(),
+                 single.GetCurrentBufferPointer(), bulk.GetSize()), 0);
+}
+
+// A stream of size prefixed buffers, read back from memory and from a file.
+void SizePrefixedStreamTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<uint8_t> stream;
+  FILE *file = tmpfile();
+  TEST_NOTNULL(file);
+  {
+    flatbuffers::SizePrefixedFileWriter writer(fileno(file), 64);
+    for (int i = 0; i < 100; i++) {
+      fbb.Clear();
+      auto name = fbb.CreateString(std::string(i, 'x'));
+      fbb.FinishSizePrefixed(CreateMonster(fbb, nullptr, 0, i, name),
+                             MonsterIdentifier());
+      TEST_EQ(flatbuffers::GetPrefixedSize(fbb.GetBufferPointer()) +
+              sizeof(flatbuffers::uoffset_t), fbb.GetSize());
+      flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+      TEST_EQ(verifier.VerifySizePrefixedBuffer<Monster>(MonsterIdentifier()),
+              true);
+      TEST_EQ(flatbuffers::GetSizePrefixedRoot<Monster>(
+                fbb.GetBufferPointer())->hp(), i);
+      stream.insert(stream.end(), fbb.GetBufferPointer(),
+                    fbb.GetBufferPointer() + fbb.GetSize());
+      TEST_EQ(writer.Write(fbb), true);
+    }
+  }  // Flushes the writer.
+
+  auto check = [](const uint8_t *buf, flatbuffers::uoffset_t len, int i) {
+    flatbuffers::Verifier verifier(buf, len);
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    TEST_EQ(GetMonster(buf)->hp(), i);
+    TEST_EQ(GetMonster(buf)->name()->size(), static_cast<size_t>(i));
+  };
+  const uint8_t *buf;
+  flatbuffers::uoffset_t len;
+  int i = 0;
+  flatbuffers::SizePrefixedBufferReader reader(stream.data(), stream.size());
+  while (reader.Next(&buf, &len)) check(buf, len, i++);
+  TEST_EQ(i, 100);
+  TEST_EQ(reader.Truncated(), false);
+
+  rewind(file);
+  i = 0;
+  flatbuffers::SizePrefixedFileReader file_reader(fileno(file), 64);
+  while (file_reader.Next(&buf, &len)) check(buf, len, i++);
+  TEST_EQ(i, 100);
+  TEST_EQ(file_reader.Truncated(), false);
+  TEST_EQ(file_reader.Error(), false);
+
+  // A size prefix above the limit is an error, instead of an allocation.
+  rewind(file);
+  flatbuffers::SizePrefixedFileReader small_reader(fileno(file), 64, 128);
+  i = 0;
+  while (small_reader.Next(&buf, &len)) check(buf, len, i++);
+  TEST_EQ(i > 0 && i < 100, true);
+  TEST_EQ(small_reader.Error(), true);
+  TEST_EQ(small_reader.Truncated(), false);
+  fclose(file);
+
+  // A buffer that got cut off is detected.
+  flatbuffers::SizePrefixedBufferReader cut(stream.data(), stream.size() - 1);
+  i = 0;
+  while (cut.Next(&buf, &len)) i++;
+  TEST_EQ(i, 99);
+  TEST_EQ(cut.Truncated(), true);
+}
+
+void MappedFileTest() {
+  flatbuffers::MappedFile file;
+  TEST_EQ(file.Open("tests/does_not_exist.mon"), false);
+  TEST_EQ(file.Open("tests/monsterdata_test.mon",
+                    flatbuffers::MappedFile::kAdviceRandom), true);
+  TEST_EQ(file.Verify<Monster>(MonsterIdentifier()), true);
+  TEST_EQ(file.GetRoot<Monster>()->hp(), 80);
+  std::string loaded;
+  TEST_EQ(flatbuffers::LoadFile("tests/monsterdata_test.mon", true, &loaded),
+          true);
+  TEST_EQ(loaded.size(), file.GetSize());
+  TEST_EQ(memcmp(loaded.c_str(), file.GetData(), loaded.size()), 0);
+  file.Close();
+  TEST_EQ(file.Verify<Monster>(), false);
+}
+
+void ParallelVerifierTest() {
+  // A monster with many monsters, each with a few monsters of their own.
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 3000; i++) {
+    std::vector<flatbuffers::Offset<Monster>> inner;
+    for (int j = 0; j < 3; j++) {
+      inner.push_back(CreateMonster(fbb, nullptr, 0, 0,
+                                    fbb.CreateString("inner")));
+    }
+    monsters.push_back(CreateMonster(fbb, nullptr, 0, 0,
+                                     fbb.CreateString("outer"), 0,
+                                     Color_Blue, Any_NONE, 0, 0, 0,
+                                     fbb.CreateVector(inner)));
+  }
+  auto tables = fbb.CreateVector(monsters);
+  FinishMonsterBuffer(fbb, CreateMonster(fbb, nullptr, 0, 0,
+                                         fbb.CreateString("root"), 0,
+                                         Color_Blue, Any_NONE, 0, 0, 0,
+                                         tables));
+
+  flatbuffers::Verifier serial(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(serial), true);
+
+  flatbuffers::ThreadPool pool(3);
+  flatbuffers::Verifier parallel(fbb.GetBufferPointer(), fbb.GetSize());
+  // Small chunks, such that the inner vectors get split up, too.
+  parallel.SetParallelFor([&](size_t n,
+                              const std::function<void(size_t)> &task) {
+    pool.ParallelFor(n, task);
+  }, 2);
+  TEST_EQ(VerifyMonsterBuffer(parallel), true);
+  TEST_EQ(parallel.GetComputedSize(), serial.GetComputedSize());
+  TEST_EQ(parallel.GetComputedSize(), fbb.GetSize());
+}
+
 // example of parsing text straight into a buffer, and generating
 // text back from it:
 void ParseAndGenerateTextTest() {
@@ -419,6 +690,349 @@ void ParseAndGenerateTextTest() {
   }
 }
 
+// Parsing and generating JSON on many threads, all sharing one schema.
+void SharedSchemaTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  flatbuffers::Parser schema;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(schema.Parse(schemafile.c_str(), include_directories), true);
+
+  flatbuffers::ThreadPool pool(3);
+  std::vector<int> round_trips(8, 0);
+  pool.ParallelFor(round_trips.size(), [&](size_t i) {
+    flatbuffers::Parser parser(schema, schema.opts);
+    for (int j = 0; j < 10; j++) {
+      std::string jsongen;
+      if (parser.Parse(jsonfile.c_str()) &&
+          GenerateText(schema, parser.builder_.GetBufferPointer(),
+                       &jsongen) &&
+          jsongen == jsonfile)
+        round_trips[i]++;
+    }
+  });
+  for (size_t i = 0; i < round_trips.size(); i++) {
+    TEST_EQ(round_trips[i], 10);
+  }
+
+  // The schema can't be changed through a parser that shares it.
+  flatbuffers::Parser parser(schema, schema.opts);
+  TEST_EQ(parser.Parse("table T { i:int; }"), false);
+  TEST_EQ(parser.Parse("{ name: \"a\" } { name: \"b\" }"), false);
+  TEST_EQ(parser.SetRootType("Stat"), true);
+  TEST_EQ(parser.Parse("{ id: \"a\" }"), true);
+  TEST_EQ(schema.structs_.vec.size() > 0 && parser.structs_.vec.empty(),
+          true);
+  TEST_EQ_STR(schema.root_struct_def_->name.c_str(), "Monster");
+
+  // Enum names resolve in the schema's namespace, as they do in JSON that
+  // follows the schema in its source.
+  const char *ns_schema = "namespace N.M; enum E:byte { A, B } "
+                          "table T { f:int; } root_type T; ";
+  const char *ns_json = "{ f: \"M.E.B\" }";
+  flatbuffers::Parser ns_owner;
+  TEST_EQ(ns_owner.Parse((std::string(ns_schema) + ns_json).c_str()), true);
+  flatbuffers::Parser ns_schema_parser;
+  TEST_EQ(ns_schema_parser.Parse(ns_schema), true);
+  flatbuffers::Parser ns_shared(ns_schema_parser, ns_schema_parser.opts);
+  TEST_EQ(ns_shared.Parse(ns_json), true);
+  TEST_EQ(ns_shared.builder_.GetSize(), ns_owner.builder_.GetSize());
+  TEST_EQ(memcmp(ns_shared.builder_.GetBufferPointer(),
+                 ns_owner.builder_.GetBufferPointer(),
+                 ns_owner.builder_.GetSize()), 0);
+}
+
+// Generating text in small chunks, and without whitespace.
+void TextSinkTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+
+  // The smallest buffer there is, to flush many times.
+  std::string jsongen;
+  size_t chunks = 0;
+  {
+    flatbuffers::BufferedTextSink sink([&](const char *text, size_t len) {
+      jsongen.append(text, len);
+      chunks++;
+      return true;
+    }, 1);
+    TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &sink),
+            true);
+    TEST_EQ(sink.Flush(), true);
+  }
+  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+  TEST_EQ(chunks > 1, true);
+
+  // A plain callback with a context, which doesn't need std::function.
+  std::string plain;
+  {
+    flatbuffers::BufferedTextSink sink(
+        [](void *context, const char *text, size_t len) {
+          static_cast<std::string *>(context)->append(text, len);
+          return true;
+        }, &plain, 1);
+    TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &sink),
+            true);
+  }
+  TEST_EQ_STR(plain.c_str(), jsonfile.c_str());
+
+  // Output errors stick.
+  flatbuffers::BufferedTextSink failing([](const char *, size_t) {
+    return false;
+  });
+  TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &failing),
+          true);
+  TEST_EQ(failing.Flush(), false);
+  failing += "more";
+  TEST_EQ(failing.Flush(), false);
+
+  // Appending to a string keeps what was there.
+  parser.opts.compact_json = true;
+  TEST_EQ(parser.Parse("{ name: \"Bob\", hp: 5, inventory: [ 1, 2 ], "
+                       "test_type: Monster, test: { name: \"Fred\" } }"),
+          true);
+  jsongen = "json: ";
+  TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &jsongen),
+          true);
+  TEST_EQ_STR(jsongen.c_str(), "json: {hp:5,name:\"Bob\",inventory:[1,2],"
+                               "test_type:Monster,test:{name:\"Fred\"}}");
+}
+
+// The generated ToJson() writes the same text as GenerateText().
+void ToJsonTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  const char *json[] = {
+    jsonfile.c_str(),
+    // Enum values without a name, escapes, and another type in the union.
+    "{ name: \"A\\t\\u20AC\", color: 3, test_type: TestSimpleTableWithEnum, "
+    "test: { color: Blue }, testarrayofstring: [], testempty: {} }",
+  };
+  for (size_t i = 0; i < sizeof(json) / sizeof(json[0]); i++) {
+    TEST_EQ(parser.Parse(json[i]), true);
+    std::string jsongen;
+    TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(), &jsongen),
+            true);
+    std::string compiled;
+    {
+      flatbuffers::StringTextSink sink(&compiled);
+      TEST_EQ(GetMonster(parser.builder_.GetBufferPointer())->ToJson(sink),
+              true);
+      sink += "\n";  // GenerateText() ends with one.
+    }
+    TEST_EQ_STR(compiled.c_str(), jsongen.c_str());
+  }
+
+  // With --defaults-json, absent fields are written like present ones.
+  std::string defaults_schema;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/defaults_json_test.fbs", false, &defaults_schema), true);
+  flatbuffers::Parser defaults_parser;
+  defaults_parser.opts.output_default_scalars_in_json = true;
+  TEST_EQ(defaults_parser.Parse(defaults_schema.c_str()), true);
+  for (int present = 0; present < 2; present++) {
+    flatbuffers::FlatBufferBuilder fbb;
+    fbb.Finish(present
+      ? DefaultsJson::CreateDefaults(fbb, false, DefaultsJson::Color_Green,
+                                     1.5f, 3, fbb.CreateString("x"))
+      : DefaultsJson::CreateDefaults(fbb));
+    std::string jsongen;
+    TEST_EQ(GenerateText(defaults_parser, fbb.GetBufferPointer(), &jsongen),
+            true);
+    std::string compiled;
+    {
+      flatbuffers::StringTextSink sink(&compiled);
+      TEST_EQ(DefaultsJson::GetDefaults(fbb.GetBufferPointer())->ToJson(sink),
+              true);
+      sink += "\n";
+    }
+    TEST_EQ_STR(compiled.c_str(), jsongen.c_str());
+    if (!present) {
+      TEST_NOTNULL(strstr(jsongen.c_str(), "flag: true"));
+      TEST_NOTNULL(strstr(jsongen.c_str(), "color: Blue"));
+    }
+  }
+}
+
+// Monster::ParseJson() should build the same FlatBuffer as the Parser.
+void ParseJsonTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  const char *json[] = {
+    jsonfile.c_str(),
+    // The union value before its type, escapes, and a trailing comma.
+    "{ test: { color: \"Blue Red\" }, test_type: TestSimpleTableWithEnum, "
+    "name: \"A\\t\\u20AC\", testhashu32_fnv1: \"x\", color: 3, "
+    "testarrayofstring: [ \"a\", ], testempty: {}, pos: null, }",
+    // Such unions nested, parsed from the recording of the outer value.
+    "{ name: \"A\", test: { name: \"B\\u20AC\", hp: -7, test: { name: \"C\", "
+    "test: { color: Green }, test_type: TestSimpleTableWithEnum }, "
+    "test_type: Monster, testarrayofstring: [ \"x\" ] }, test_type: 1 }",
+    // null doesn't set a field, before or after a value for it.
+    "{ name: \"A\", hp: null, hp: 5, mana: 7, mana: null }",
+  };
+  for (size_t i = 0; i < sizeof(json) / sizeof(json[0]); i++) {
+    TEST_EQ(parser.Parse(json[i]), true);
+    flatbuffers::FlatBufferBuilder fbb;
+    std::string error;
+    TEST_EQ(Monster::ParseJson(json[i], strlen(json[i]), fbb, &error), true);
+    TEST_EQ_STR(error.c_str(), "");
+    TEST_EQ(fbb.GetSize(), parser.builder_.GetSize());
+    TEST_EQ(memcmp(fbb.GetBufferPointer(), parser.builder_.GetBufferPointer(),
+                   fbb.GetSize()), 0);
+  }
+  // A struct after other values: the Parser pads while parsing it, so only
+  // the data is the same.
+  const char *same_data[] = {
+    "{ name: \"A\", pos: { x: 1, y: 2, z: 3, test1: 3, test2: Red, "
+    "test3: { a: 1, b: 2 } } }",
+    "{ name: \"A\", pos: { x: 1, y: 2, z: 3, test1: 3, test2: Red, "
+    "test3: { a: 1, b: 2 } }, pos: null }",
+  };
+  for (size_t i = 0; i < sizeof(same_data) / sizeof(same_data[0]); i++) {
+    TEST_EQ(parser.Parse(same_data[i]), true);
+    std::string expected;
+    TEST_EQ(GenerateText(parser, parser.builder_.GetBufferPointer(),
+                         &expected), true);
+    flatbuffers::FlatBufferBuilder fbb;
+    std::string error;
+    TEST_EQ(Monster::ParseJson(same_data[i], strlen(same_data[i]), fbb,
+                               &error), true);
+    TEST_EQ_STR(error.c_str(), "");
+    flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    std::string text;
+    TEST_EQ(GenerateText(parser, fbb.GetBufferPointer(), &text), true);
+    TEST_EQ_STR(text.c_str(), expected.c_str());
+  }
+  // Unlike the Parser, missing required fields are an error (see below).
+  TEST_EQ(parser.Parse("{ hp: 1 }"), true);
+  const char *errors[][2] = {
+    { "{ name: \"A\", foo: 1 }", "1:0: error: unknown field: foo" },
+    { "{ name: \"A\", name: \"B\" }",
+      "1:0: error: field set more than once: name" },
+    { "{ hp: 1 }", "1:0: error: missing required field: name" },
+    { "{ name: \"A\", test: {}, hp: 1 }",
+      "1:0: error: missing type field after this union value: test_type" },
+    { "{ name: \"A\", color: Purple }", "1:0: error: unknown enum value: "
+      "Purple" },
+    { "{ name: \"A\" } {}", "1:0: error: cannot have more than one json "
+      "object" },
+    // Also where plain char is unsigned.
+    { "{ name: \"\xC3\" }", "1:0: error: illegal UTF-8 sequence" },
+    { "{ name: \"A\", hp: \x80 }", "1:0: error: illegal character: code: "
+      "128" },
+    // Lexed by the same rules as in the Parser.
+    { "{ name: \"\\uD800\\u0041\" }", "1:0: error: illegal Unicode sequence "
+      "(unpaired high surrogate)" },
+    { "{ name: \"A\", hp: .5 }", "1:0: error: floating point constant can't "
+      "start with \".\"" },
+  };
+  for (size_t i = 0; i < sizeof(errors) / sizeof(errors[0]); i++) {
+    flatbuffers::FlatBufferBuilder fbb;
+    std::string error;
+    TEST_EQ(Monster::ParseJson(errors[i][0], strlen(errors[i][0]), fbb,
+                               &error), false);
+    TEST_EQ_STR(error.c_str(), errors[i][1]);
+  }
+}
+
+// Loading a schema from its binary form, instead of parsing it.
+void BinarySchemaTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  flatbuffers::IDLOptions opts;
+  opts.binary_schema_builtins = true;  // For the "hash" attributes.
+  flatbuffers::Parser parser(opts);
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  parser.Serialize();
+  std::string bfbs(
+    reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+    parser.builder_.GetSize());
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+
+  auto bfbs_buf = reinterpret_cast<const uint8_t *>(bfbs.c_str());
+  flatbuffers::Verifier verifier(bfbs_buf, bfbs.length());
+  TEST_EQ(reflection::VerifySchemaBuffer(verifier), true);
+  flatbuffers::Parser loaded(opts);
+  TEST_EQ(loaded.Deserialize(bfbs_buf), true);
+  TEST_EQ(loaded.SetRootType("Stat"), true);
+  TEST_EQ(loaded.SetRootType("Monster"), true);
+  // Same schema, so the same JSON turns into the same binary and back.
+  TEST_EQ(loaded.Parse(jsonfile.c_str()), true);
+  TEST_EQ(loaded.builder_.GetSize(), parser.builder_.GetSize());
+  TEST_EQ(memcmp(loaded.builder_.GetBufferPointer(),
+                 parser.builder_.GetBufferPointer(),
+                 parser.builder_.GetSize()), 0);
+  std::string jsongen;
+  TEST_EQ(GenerateText(loaded, loaded.builder_.GetBufferPointer(), &jsongen),
+          true);
+  TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
+  // And the same binary schema, though with its tables in a different order.
+  loaded.Serialize();
+  TEST_EQ(loaded.builder_.GetSize(), bfbs.length());
+
+  TEST_EQ(loaded.Deserialize(bfbs_buf), false);
+
+  // Schemas that verify, but don't make sense, are rejected.
+  std::vector<flatbuffers::Offset<reflection::Field>> no_fields;
+  std::vector<flatbuffers::Offset<reflection::Object>> objects;
+  std::vector<flatbuffers::Offset<reflection::Enum>> no_enums;
+  flatbuffers::FlatBufferBuilder fbb;
+  auto missing = reflection::CreateObjectDirect(fbb, "Missing", &no_fields);
+  fbb.Finish(reflection::CreateSchemaDirect(fbb, &objects, &no_enums, nullptr,
+                                            nullptr, missing),
+             reflection::SchemaIdentifier());
+  flatbuffers::Verifier no_root_verifier(fbb.GetBufferPointer(),
+                                         fbb.GetSize());
+  TEST_EQ(reflection::VerifySchemaBuffer(no_root_verifier), true);
+  flatbuffers::Parser no_root;
+  TEST_EQ(no_root.Deserialize(fbb.GetBufferPointer()), false);
+  TEST_EQ_STR(no_root.error_.c_str(), "binary schema is inconsistent");
+  fbb.Clear();
+  objects.push_back(reflection::CreateObjectDirect(fbb, "Twice", &no_fields));
+  objects.push_back(objects.back());
+  fbb.Finish(reflection::CreateSchemaDirect(fbb, &objects, &no_enums),
+             reflection::SchemaIdentifier());
+  flatbuffers::Parser duplicate;
+  TEST_EQ(duplicate.Deserialize(fbb.GetBufferPointer()), false);
+
+  flatbuffers::Parser empty;
+  TEST_EQ(empty.Deserialize(
+            reinterpret_cast<const uint8_t *>(jsonfile.c_str())), false);
+}
+
 void ReflectionTest(uint8_t *flatbuf, size_t length) {
   // Load a binary schema.
   std::string bfbsfile;
@@ -563,6 +1177,77 @@ void ReflectionTest(uint8_t *flatbuf, size_t length) {
   AccessFlatBufferTest(fbb.GetBufferPointer(), fbb.GetSize());
 }
 
+// Resizes done in one ResizeTransaction should give the same result as
+// doing them one at a time.
+void ResizeTransactionTest(const uint8_t *flatbuf, size_t length) {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.bfbs", true, &bfbsfile), true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  auto fields = schema.root_table()->fields();
+  auto &name_field = *fields->LookupByKey("name");
+  auto &inventory_field = *fields->LookupByKey("inventory");
+  auto &testarrayofstring_field = *fields->LookupByKey("testarrayofstring");
+  typedef flatbuffers::Offset<flatbuffers::String> StringOffset;
+
+  std::vector<uint8_t> one_at_a_time(flatbuf, flatbuf + length);
+  auto root = flatbuffers::piv(flatbuffers::GetAnyRoot(one_at_a_time.data()),
+                               one_at_a_time);
+  SetString(schema, "totally new string", GetFieldS(**root, name_field),
+            &one_at_a_time);
+  flatbuffers::ResizeVector<uint8_t>(schema, 110, 50,
+      flatbuffers::GetFieldV<uint8_t>(**root, inventory_field),
+      &one_at_a_time);
+  SetString(schema, "bobby",
+            flatbuffers::GetFieldV<StringOffset>(
+              **root, testarrayofstring_field)->Get(0),
+            &one_at_a_time);
+
+  std::vector<uint8_t> batched(flatbuf, flatbuf + length);
+  auto &monster = *flatbuffers::GetAnyRoot(batched.data());
+  auto strings = flatbuffers::GetFieldV<StringOffset>(
+                   monster, testarrayofstring_field);
+  flatbuffers::ResizeTransaction transaction(schema, &batched);
+  transaction.SetString("bobby", strings->Get(0));
+  transaction.ResizeVector<uint8_t>(110, 50,
+      flatbuffers::GetFieldV<uint8_t>(monster, inventory_field));
+  transaction.SetString("totally new string", GetFieldS(monster, name_field));
+  transaction.Commit();
+  TEST_EQ(batched.size(), one_at_a_time.size());
+  TEST_EQ(memcmp(batched.data(), one_at_a_time.data(), batched.size()), 0);
+
+  // Shrinking, which also removes the elements rather than what follows.
+  auto &resized = *flatbuffers::GetAnyRoot(batched.data());
+  auto inventory = flatbuffers::GetFieldV<uint8_t>(resized, inventory_field);
+  transaction.ResizeVector<uint8_t>(5, 0, inventory);
+  transaction.SetString("x", GetFieldS(resized, name_field));
+  transaction.SetString("", flatbuffers::GetFieldV<StringOffset>(
+                                resized, testarrayofstring_field)->Get(1));
+  transaction.Commit();
+  TEST_EQ(batched.size() < one_at_a_time.size(), true);
+  flatbuffers::Verifier verifier(batched.data(), batched.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto shrunk = GetMonster(batched.data());
+  TEST_EQ_STR(shrunk->name()->c_str(), "x");
+  TEST_EQ(shrunk->inventory()->size(), 5);
+  for (flatbuffers::uoffset_t i = 0; i < 5; i++) {
+    TEST_EQ(shrunk->inventory()->Get(i), i);
+  }
+  TEST_EQ_STR(shrunk->testarrayofstring()->Get(0)->c_str(), "bobby");
+  TEST_EQ_STR(shrunk->testarrayofstring()->Get(1)->c_str(), "");
+  // Everything else is still there.
+  auto original = GetMonster(flatbuf);
+  auto tables = shrunk->testarrayoftables();
+  TEST_EQ(tables->size(), original->testarrayoftables()->size());
+  for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++) {
+    TEST_EQ_STR(tables->Get(i)->name()->c_str(),
+                original->testarrayoftables()->Get(i)->name()->c_str());
+  }
+  auto enemy = static_cast<const Monster *>(shrunk->test());
+  auto original_enemy = static_cast<const Monster *>(original->test());
+  TEST_EQ_STR(enemy->name()->c_str(), original_enemy->name()->c_str());
+}
+
 // Parse a .proto schema, output as .fbs
 void ParseProtoTest() {
   // load the .proto and the golden file from disk
@@ -593,6 +1278,15 @@ void ParseProtoTest() {
     printf("%s----------------\n%s", fbs.c_str(), goldenfile.c_str());
     TEST_NOTNULL(NULL);
   }
+
+  // The package stays current after importing a file with another package.
+  flatbuffers::Parser package_first(opts);
+  TEST_EQ(package_first.Parse("package p.q;\n"
+                              "import \"imported.proto\";\n"
+                              "message M { optional int32 b = 1; }\n",
+                              include_directories), true);
+  TEST_NOTNULL(package_first.structs_.Lookup("p.q.M"));
+  TEST_NOTNULL(package_first.structs_.Lookup("proto.test.ImportedMessage"));
 }
 
 template<typename T> void CompareTableFieldValue(flatbuffers::Table *table,
@@ -861,6 +1555,15 @@ void FuzzTest2() {
          static_cast<int>(json.length() / 1024));
 }
 
+// How parser errors refer to a line, e.g. "12:" or "(12)".
+std::string ErrorLine(int line) {
+  #ifdef _WIN32
+    return "(" + flatbuffers::NumToString(line) + ")";
+  #else
+    return flatbuffers::NumToString(line) + ":";
+  #endif
+}
+
 // Test that parser errors are actually generated.
 void TestError(const char *src, const char *error_substr,
                bool strict_json = false) {
@@ -946,6 +1649,88 @@ void ValueTest() {
 
   // Test negative hex constant.
   TEST_EQ(TestValue<int>("{ Y:-0x80 }","int") == -128, true);
+
+  // Test numbers in strings.
+  TEST_EQ(TestValue<int>("{ Y:\"-10\" }","int") == -10, true);
+  TEST_EQ(TestValue<float>("{ Y:\"0.5\" }","float") == 0.5f, true);
+
+  // Test structs nested in structs and in vectors, which are kept aside until
+  // their parent is serialized.
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("struct A { x:short; y:byte; }"
+                       "struct B { a:A; b:int; }"
+                       "table T { b:B; v:[B]; d:int = 5; }"
+                       "root_type T;"
+                       "{ v: [ { a: { x: 1, y: 2 }, b: 3 },"
+                       "       { a: { x: 4, y: 5 }, b: 6 } ],"
+                       "  b: { a: { x: 7, y: 8 }, b: 9 }, d: 5 }"), true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                parser.builder_.GetBufferPointer());
+  auto b = root->GetStruct<const uint8_t *>(4);
+  TEST_EQ(flatbuffers::ReadScalar<int16_t>(b), 7);
+  TEST_EQ(flatbuffers::ReadScalar<int8_t>(b + 2), 8);
+  TEST_EQ(flatbuffers::ReadScalar<int32_t>(b + 4), 9);
+  auto v = root->GetPointer<const flatbuffers::Vector<uint8_t> *>(6);
+  TEST_EQ(v->size(), 2);
+  TEST_EQ(flatbuffers::ReadScalar<int16_t>(v->Data()), 1);
+  TEST_EQ(flatbuffers::ReadScalar<int32_t>(v->Data() + 4), 3);
+  TEST_EQ(flatbuffers::ReadScalar<int8_t>(v->Data() + 10), 5);
+  TEST_EQ(flatbuffers::ReadScalar<int32_t>(v->Data() + 12), 6);
+  // Values equal to their default are left out.
+  TEST_EQ(root->CheckField(8), false);
+}
+
+void NumToStringTest() {
+  TEST_EQ_STR(flatbuffers::NumToString(0).c_str(), "0");
+  // Only signed and unsigned char are numbers, plain char is a character.
+  TEST_EQ_STR(flatbuffers::NumToString('A').c_str(), "A");
+  TEST_EQ_STR(flatbuffers::NumToString(static_cast<unsigned char>(65)).c_str(),
+              "65");
+  TEST_EQ_STR(flatbuffers::NumToString(static_cast<int8_t>(-128)).c_str(),
+              "-128");
+  TEST_EQ_STR(flatbuffers::NumToString(INT64_MIN).c_str(),
+              "-9223372036854775808");
+  TEST_EQ_STR(flatbuffers::NumToString(UINT64_MAX).c_str(),
+              "18446744073709551615");
+  TEST_EQ_STR(flatbuffers::NumToString(1.0).c_str(), "1");
+  TEST_EQ_STR(flatbuffers::NumToString(-0.0).c_str(), "-0");
+  TEST_EQ_STR(flatbuffers::NumToString(3.14159f).c_str(), "3.14159");
+  TEST_EQ_STR(flatbuffers::NumToString(0.1).c_str(), "0.1");
+  TEST_EQ_STR(flatbuffers::NumToString(1e-7f).c_str(), "0.0000001");
+  TEST_EQ_STR(flatbuffers::NumToString(1e21).c_str(),
+              "1000000000000000000000");
+  TEST_EQ_STR(flatbuffers::NumToString(0.1234567890123).c_str(),
+              "0.1234567890123");
+  TEST_EQ_STR(flatbuffers::IntToStringHex(0x23, 8).c_str(), "00000023");
+  TEST_EQ_STR(flatbuffers::IntToStringHex(0xABCDE, 2).c_str(), "ABCDE");
+
+  // Random bit patterns must read back as the same value.
+  lcg_reset();
+  for (int i = 0; i < 10000; i++) {
+    uint64_t bits = (static_cast<uint64_t>(lcg_rand()) << 32) | lcg_rand();
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    if (d != d || d - d != 0) continue;  // NaN or infinite.
+    auto s = flatbuffers::NumToString(d);
+    TEST_EQ(flatbuffers::StringToDouble(s.c_str()) == d, true);
+    auto f = static_cast<float>(lcg_rand() % 100000000) / 1000;
+    TEST_EQ(strtof(flatbuffers::NumToString(f).c_str(), nullptr) == f, true);
+    auto i64 = static_cast<int64_t>(bits) >> (lcg_rand() % 64);
+    TEST_EQ(flatbuffers::StringToInt(flatbuffers::NumToString(i64).c_str()),
+            i64);
+  }
+
+  // Values StringToDouble() converts itself must match strtod() exactly.
+  const char *doubles[] = { "0.1", "-1.5e-7", "123456789012345", "1e22",
+                            "1e23", ".5", "1e", "0x10", "9007199254740993",
+                            "4.9e-324", "12.50x", nullptr };
+  for (auto p = doubles; *p; p++) {
+    char *end1, *end2;
+    auto d1 = flatbuffers::StringToDouble(*p, &end1);
+    auto d2 = strtod(*p, &end2);
+    TEST_EQ(memcmp(&d1, &d2, sizeof(d1)), 0);
+    TEST_EQ(end1 - *p, end2 - *p);
+  }
 }
 
 void EnumStringsTest() {
@@ -959,6 +1744,34 @@ void EnumStringsTest() {
                         "{ F:[ \"E.C\", \"E.A E.B E.C\" ] }"), true);
 }
 
+void ReverseLookupTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("enum Dense:short { A = -2, B, C = 5, D }"
+                       "enum Sparse:int { X = -100000, Y = 100000 }"
+                       "union U { T }"
+                       "table T { a:int (id: 1); b:int (id: 0); }"
+                       "root_type T;"), true);
+  auto dense = parser.enums_.Lookup("Dense");
+  TEST_EQ_STR(dense->ReverseLookup(-2)->name.c_str(), "A");
+  TEST_EQ_STR(dense->ReverseLookup(-1)->name.c_str(), "B");
+  TEST_EQ_STR(dense->ReverseLookup(6)->name.c_str(), "D");
+  TEST_EQ(dense->ReverseLookup(0) == nullptr, true);
+  TEST_EQ(dense->ReverseLookup(-3) == nullptr, true);
+  TEST_EQ(dense->ReverseLookup(7) == nullptr, true);
+  auto sparse = parser.enums_.Lookup("Sparse");
+  TEST_EQ_STR(sparse->ReverseLookup(100000)->name.c_str(), "Y");
+  TEST_EQ(sparse->ReverseLookup(0) == nullptr, true);
+  auto u = parser.enums_.Lookup("U");
+  TEST_EQ(u->ReverseLookup(0) == nullptr, true);
+  TEST_EQ_STR(u->ReverseLookup(0, false)->name.c_str(), "NONE");
+  TEST_EQ_STR(u->ReverseLookup(1)->name.c_str(), "T");
+
+  // Fields in and out of the order they were declared in.
+  TEST_EQ(parser.Parse("{ b: 1, a: 2 }"), true);
+  TEST_EQ(parser.Parse("{ a: 2, b: 1 }"), true);
+  TEST_EQ(parser.Parse("{ b: 1, a: 2, b: 3 }"), false);
+}
+
 void IntegerOutOfRangeTest() {
   TestError("table T { F:byte; } root_type T; { F:256 }",
             "constant does not fit");
@@ -984,6 +1797,7 @@ void IntegerOutOfRangeTest() {
             "constant does not fit");
   TestError("table T { F:uint; } root_type T; { F:-4294967297 }",
             "constant does not fit");
+  TestError("table T { F:byte = 256; }", "constant does not fit");
 }
 
 void UnicodeTest() {
@@ -1039,6 +1853,37 @@ void UnicodeTestGenerateTextFailsOnNonUTF8() {
   TEST_EQ(result, false);
 }
 
+// Strings of random pieces that do and don't need escaping, at random
+// offsets, must read back as they were.
+void EscapeStringTest() {
+  flatbuffers::Parser parser;
+  parser.opts.indent_step = -1;
+  TEST_EQ(parser.Parse("table T { F:string; } root_type T;"), true);
+  const char *pieces[] = {
+    "a", "plain text", "\"", "\\", "\n", "\t", "\x01", "\x1F", "\x7F", " ~",
+    "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x8E"
+  };
+  const int num_pieces = sizeof(pieces) / sizeof(pieces[0]);
+  lcg_reset();
+  for (int i = 0; i < 200; i++) {
+    std::string str;
+    auto len = lcg_rand() % 40;
+    for (uint32_t j = 0; j < len; j++) str += pieces[lcg_rand() % num_pieces];
+    flatbuffers::FlatBufferBuilder fbb;
+    auto offset = fbb.CreateString(str);
+    auto start = fbb.StartTable();
+    fbb.AddOffset(4, offset);
+    fbb.Finish(flatbuffers::Offset<flatbuffers::Table>(fbb.EndTable(start, 1)));
+    std::string jsongen;
+    TEST_EQ(GenerateText(parser, fbb.GetBufferPointer(), &jsongen), true);
+    TEST_EQ(parser.Parse(jsongen.c_str()), true);
+    auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                  parser.builder_.GetBufferPointer());
+    auto parsed = root->GetPointer<flatbuffers::String *>(4);
+    TEST_EQ_STR(parsed->c_str(), str.c_str());
+  }
+}
+
 void UnicodeSurrogatesTest() {
   flatbuffers::Parser parser;
 
@@ -1167,6 +2012,127 @@ void InvalidUTF8Test() {
     "{ F:\"\xED\xA0\x81\xED\xB0\x80\"}", "illegal UTF-8 sequence");
 }
 
+// The lexer scans strings 8 bytes at a time, so test escapes and UTF-8
+// sequences at every position within such a word.
+void StringScanTest() {
+  for (size_t i = 0; i < 20; i++) {
+    std::string plain(i, 'a');
+    flatbuffers::Parser parser;
+    TEST_EQ(parser.Parse(("table T { F:string; } root_type T;"
+                          "{ F:\"" + plain + "\\\"\xE2\x82\xAC" + plain +
+                          "\\t\" }").c_str()), true);
+    auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                  parser.builder_.GetBufferPointer());
+    auto str = root->GetPointer<const flatbuffers::String *>(4);
+    TEST_EQ(str->str(), plain + "\"\xE2\x82\xAC" + plain + "\t");
+    TestError(("table T { F:string; } root_type T;"
+               "{ F:\"" + plain + "\xC0\x8A" + plain + "\" }").c_str(),
+              "illegal UTF-8 sequence");
+    TestError(("table T { F:string; } root_type T;"
+               "{ F:\"" + plain + "\n" + plain + "\" }").c_str(),
+              "illegal character in string constant");
+  }
+  // Invalid UTF-8 can also come from escape codes.
+  TestError("table T { F:string; } root_type T; { F:\"\\xC0\\x8A\" }",
+            "illegal UTF-8 sequence");
+}
+
+void ChunkedParseTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { s:string; v:[int]; } root_type T;"), true);
+  const std::string json = "// {\n{ s: \"[ \\\"}\", /* } */ v: [ 1, 2, 3 ] }\n";
+  TEST_EQ(parser.Parse(json.c_str()), true);
+  std::string expected(
+    reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+    parser.builder_.GetSize());
+
+  // A source that isn't 0-terminated.
+  std::vector<char> unterminated(json.begin(), json.end());
+  TEST_EQ(parser.ParseBuffer(&unterminated[0], unterminated.size()), true);
+  TEST_EQ(std::string(
+            reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+            parser.builder_.GetSize()), expected);
+  const char with_0_byte[] = "{ s: \"a\" }\0{}";
+  TEST_EQ(parser.ParseBuffer(with_0_byte, sizeof(with_0_byte) - 1), false);
+  // A comment at the very end, followed by bytes that must not be read.
+  const char comment_at_end[] = "table U { a:int; } ///";
+  flatbuffers::Parser schema_parser;
+  TEST_EQ(schema_parser.ParseBuffer(comment_at_end,
+                                    sizeof(comment_at_end) - 2), true);
+  // Existing calls passing 0 or NULL include paths still compile.
+  TEST_EQ(parser.Parse(json.c_str(), 0), true);
+  TEST_EQ(parser.Parse(json.c_str(), NULL), true);
+
+  // The same JSON, split up into chunks of any size.
+  for (size_t size = 1; size <= json.length(); size++) {
+    flatbuffers::ChunkedJsonParser chunked(parser);
+    TEST_EQ(chunked.Done(), false);
+    for (size_t i = 0; i < json.length(); i += size) {
+      TEST_EQ(chunked.Feed(json.c_str() + i,
+                           std::min(size, json.length() - i)), true);
+    }
+    TEST_EQ(chunked.Done(), true);
+    TEST_EQ(chunked.Finish(), true);
+    TEST_EQ(std::string(
+              reinterpret_cast<const char *>(
+                parser.builder_.GetBufferPointer()),
+              parser.builder_.GetSize()), expected);
+  }
+
+  flatbuffers::ChunkedJsonParser incomplete(parser);
+  TEST_EQ(incomplete.Feed("{ s: \"}\"", 9), true);
+  TEST_EQ(incomplete.Finish(), false);
+  flatbuffers::ChunkedJsonParser two_objects(parser);
+  TEST_EQ(two_objects.Feed("{}{}", 4), false);
+  TEST_NOTNULL(strstr(parser.error_.c_str(), "more than one json object"));
+}
+
+void JsonStreamTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { i:int; s:string; } root_type T;"), true);
+  const std::string json = "{ i: 1, s: \"}\" }\n{ i: 2 }\n\n{ i: 3 }\n";
+  std::vector<std::string> buffers;
+  auto collect = [&](const flatbuffers::FlatBufferBuilder &fbb) {
+    buffers.push_back(std::string(
+      reinterpret_cast<const char *>(fbb.GetBufferPointer()), fbb.GetSize()));
+    return true;
+  };
+  auto check = [&]() {
+    TEST_EQ(buffers.size(), 3);
+    for (size_t i = 0; i < buffers.size(); i++) {
+      auto buf = reinterpret_cast<const uint8_t *>(buffers[i].c_str());
+      TEST_EQ(flatbuffers::GetPrefixedSize(buf) +
+              sizeof(flatbuffers::uoffset_t), buffers[i].size());
+      auto root = flatbuffers::GetSizePrefixedRoot<flatbuffers::Table>(buf);
+      TEST_EQ(root->GetField<int>(4, 0), static_cast<int>(i + 1));
+    }
+    buffers.clear();
+  };
+
+  TEST_EQ(parser.ParseJsonStream(json.c_str(), json.length(), collect, true),
+          true);
+  check();
+
+  // The same stream, split up into chunks of any size.
+  for (size_t size = 1; size <= json.length(); size++) {
+    flatbuffers::ChunkedJsonParser chunked(parser, collect, true);
+    for (size_t i = 0; i < json.length(); i += size) {
+      TEST_EQ(chunked.Feed(json.c_str() + i,
+                           std::min(size, json.length() - i)), true);
+    }
+    TEST_EQ(chunked.Finish(), true);
+    check();
+  }
+
+  // Errors mention the line the object is on.
+  TEST_EQ(parser.ParseJsonStream("{ i: 1 }\n{ j: 2 }", 17, collect), false);
+  TEST_NOTNULL(strstr(parser.error_.c_str(), ErrorLine(2).c_str()));
+  TEST_EQ(parser.ParseJsonStream(json.c_str(), json.length(),
+            [](const flatbuffers::FlatBufferBuilder &) { return false; }),
+          false);
+  buffers.clear();
+}
+
 void UnknownFieldsTest() {
   flatbuffers::IDLOptions opts;
   opts.skip_unexpected_fields_in_json = true;
@@ -1204,6 +2170,81 @@ void ParseUnionTest() {
   TEST_EQ(parser2.Parse("namespace N; table A {} namespace; union U { N.A }"
                         "table B { e:U; } root_type B;"
                         "{ e_type: N_A, e: {} }"), true);
+  // Nested unions, with types after their values, and other fields between.
+  flatbuffers::Parser parser3;
+  TEST_EQ(parser3.Parse("enum E:byte { Red, Green }"
+                        "table A { e:E; n:int; } union U { A, B }"
+                        "table B { x:U; y:U; }"
+                        "root_type B;"), true);
+  TEST_EQ(parser3.Parse("{ y_type: A, x: { y: { e: Green },\n"
+                        "                  y_type: A,\n"
+                        "                  x: { x: { n: 3 }, x_type: A },\n"
+                        "                  x_type: B },\n"
+                        "  x_type: B, y: { n: 1 } }"), true);
+  std::string jsongen;
+  parser3.opts.indent_step = -1;
+  TEST_EQ(GenerateText(parser3, parser3.builder_.GetBufferPointer(),
+                       &jsongen), true);
+  TEST_EQ_STR(jsongen.c_str(),
+              "{x_type: B,x: {x_type: B,x: {x_type: A,x: {n: 3}},"
+              "y_type: A,y: {e: Green}},y_type: A,y: {n: 1}}");
+  // Only this union's own type field counts.
+  TEST_EQ(parser3.Parse("{ y_type: A, x: { n: 1 }, x_type: B }"), false);
+  // Errors inside a recorded value report their own line.
+  TEST_EQ(parser3.Parse("{ x: {\n y: { z: 1 }, y_type: A }, x_type: B }"),
+          false);
+  TEST_NOTNULL(strstr(parser3.error_.c_str(), ErrorLine(2).c_str()));
+}
+
+// In-memory files for IncludeTest, with how often they were looked for.
+std::map<std::string, std::string> include_test_files;
+int include_test_lookups = 0;
+
+bool IncludeTestLoadFile(const char *name, bool /*binary*/,
+                         std::string *buf) {
+  auto it = include_test_files.find(name);
+  if (it == include_test_files.end()) return false;
+  *buf = it->second;
+  return true;
+}
+
+bool IncludeTestFileExists(const char *name) {
+  include_test_lookups++;
+  return include_test_files.find(name) != include_test_files.end();
+}
+
+void IncludeTest() {
+  auto load_file = flatbuffers::SetLoadFileFunction(IncludeTestLoadFile);
+  auto file_exists =
+    flatbuffers::SetFileExistsFunction(IncludeTestFileExists);
+  // Each file includes all files before it, and declares a namespace.
+  std::string includes;
+  for (int i = 0; i < 20; i++) {
+    auto n = flatbuffers::NumToString(i);
+    include_test_files["f" + n + ".fbs"] =
+      includes + "namespace N" + n + "; table T { i:int; }";
+    includes += "include \"f" + n + ".fbs\";\n";
+  }
+  flatbuffers::Parser parser;
+  auto source = includes + "table T { t:N19.T; }\nroot_type T;\n";
+  TEST_EQ(parser.Parse(source.c_str(), nullptr, "main.fbs"), true);
+  TEST_EQ(parser.structs_.vec.size(), 21);
+  // The file after the includes is in no namespace.
+  TEST_EQ_STR(parser.root_struct_def_->defined_namespace->
+                GetFullyQualifiedName("T").c_str(), "T");
+  // Each file is only looked for once.
+  TEST_EQ(include_test_lookups, 20);
+
+  // Errors after includes point at the right line.
+  flatbuffers::Parser parser2;
+  source = includes + "table T { t:N19.T; }\nroot_type U;\n";
+  TEST_EQ(parser2.Parse(source.c_str(), nullptr, "main.fbs"), false);
+  TEST_NOTNULL(strstr(parser2.error_.c_str(), "main.fbs"));
+  TEST_NOTNULL(strstr(parser2.error_.c_str(), ErrorLine(22).c_str()));
+
+  flatbuffers::SetLoadFileFunction(load_file);
+  flatbuffers::SetFileExistsFunction(file_exists);
+  include_test_files.clear();
 }
 
 void ConformTest() {
@@ -1237,10 +2278,24 @@ int main(int /*argc*/, const char * /*argv*/[]) {
 
   ObjectFlatBuffersTest(flatbuf.get());
 
+  BuilderReuseTest();
+  VTableDedupTest();
+  SharedStringTest();
+  BulkVectorTest();
+  ParallelVerifierTest();
+
   #ifndef FLATBUFFERS_NO_FILE_TESTS
   ParseAndGenerateTextTest();
+  SharedSchemaTest();
+  TextSinkTest();
+  ToJsonTest();
+  ParseJsonTest();
+  BinarySchemaTest();
   ReflectionTest(flatbuf.get(), rawbuf.length());
+  ResizeTransactionTest(flatbuf.get(), rawbuf.length());
   ParseProtoTest();
+  SizePrefixedStreamTest();
+  MappedFileTest();
   #endif
 
   FuzzTest1();
@@ -1248,16 +2303,23 @@ int main(int /*argc*/, const char * /*argv*/[]) {
 
   ErrorTest();
   ValueTest();
+  NumToStringTest();
   EnumStringsTest();
+  ReverseLookupTest();
   IntegerOutOfRangeTest();
   UnicodeTest();
   UnicodeTestAllowNonUTF8();
   UnicodeTestGenerateTextFailsOnNonUTF8();
+  EscapeStringTest();
   UnicodeSurrogatesTest();
   UnicodeInvalidSurrogatesTest();
   InvalidUTF8Test();
+  StringScanTest();
+  ChunkedParseTest();
+  JsonStreamTest();
   UnknownFieldsTest();
   ParseUnionTest();
+  IncludeTest();
   ConformTest();
 
   if (!testing_fails) {